@@ -134,4 +134,58 @@ Item {
             gc();
         }
     }
+
+    TestCase {
+        id: propagation
+        name: "propagation"
+
+        property var tree: null
+
+        function initTestCase() {
+            tree = sharedTreeRoot.createObject(propagation, { mode: "styleSet" });
+        }
+
+        function cleanupTestCase() {
+            tree.destroy();
+            gc();
+        }
+
+        function benchmark_renameRootOfSharedTree() {
+            tree.StyleSet.name = tree.StyleSet.name === "renamed" ? "" : "renamed";
+            // let the path propagation scheduled by the rename run
+            wait(0);
+        }
+    }
+
+    TestCase {
+        id: lookup
+        name: "lookup"
+
+        A {
+            B {
+                C {
+                    D {
+                        Rectangle {
+                            id: lookupItem
+                            property var props: StyleSet.props
+                        }
+                    }
+                }
+            }
+        }
+
+        function benchmark_colorLookup() {
+            var props = lookupItem.props;
+            for (var i = 0; i < 10000; i++) {
+                props.color("background");
+            }
+        }
+
+        function benchmark_valuesLookup() {
+            var props = lookupItem.props;
+            for (var i = 0; i < 10000; i++) {
+                props.values("something");
+            }
+        }
+    }
 }
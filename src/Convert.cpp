@@ -37,6 +37,7 @@ SUPPRESS_WARNINGS
 RESTORE_WARNINGS
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <iostream>
 #include <string>
@@ -523,10 +524,28 @@ struct PropValueToVariantVisitor : public boost::static_visitor<QVariant> {
     return boost::apply_visitor(visitor, exprValue);
   }
 };
+
+std::atomic<std::size_t>& conversionCounter()
+{
+  static std::atomic<std::size_t> sCounter(0);
+  return sCounter;
+}
 } // anon namespace
 
+void countConversion()
+{
+  conversionCounter().fetch_add(1, std::memory_order_relaxed);
+}
+
+std::size_t conversionCount()
+{
+  return conversionCounter().load(std::memory_order_relaxed);
+}
+
 QVariant convertValueToVariant(const PropertyValue& value)
 {
+  countConversion();
+
   PropValueToVariantVisitor visitor;
   return boost::apply_visitor(visitor, value);
 }
@@ -93,14 +93,24 @@ struct PropertyValueConvertTraits<QUrl> {
   boost::optional<QUrl> convert(const PropertyValue& value) const;
 };
 
+void countConversion();
+
 template <typename T, typename Traits = PropertyValueConvertTraits<T>>
 boost::optional<T> convertProperty(const PropertyValue& value, Traits traits = Traits())
 {
+  countConversion();
   return traits.convert(value);
 }
 
 QVariant convertValueToVariant(const PropertyValue& value);
 QVariantList convertValueToVariantList(const PropertyValues& values);
 
+/*! Returns the number of property values converted so far
+ *
+ * Counts the calls of convertProperty() and convertValueToVariant() from all
+ * threads, failed conversions included.
+ */
+std::size_t conversionCount();
+
 } // namespace stylesheets
 } // namespace aqt
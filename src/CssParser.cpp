@@ -22,6 +22,7 @@ THE SOFTWARE.
 
 #include "CssParser.hpp"
 
+#include "Trace.hpp"
 #include "Warnings.hpp"
 
 SUPPRESS_WARNINGS
@@ -60,6 +61,8 @@ namespace stylesheets
 
 StyleSheet parseStdString(const std::string& data)
 {
+  AQT_STYLESHEETS_TRACE_SCOPE("parseStyleSheet");
+
   StyleSheet stylesheet;
 
   using namespace peg;
@@ -227,6 +230,8 @@ StyleSheet parseString(const QString& data)
 
 StyleSheet parseStyleFile(const QString& path)
 {
+  AQT_STYLESHEETS_TRACE_SCOPE("parseStyleFile");
+
   return parseStdString(loadFileIntoString(path.toStdString()));
 }
 
@@ -0,0 +1,169 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "PathTrie.hpp"
+
+#include "Warnings.hpp"
+
+SUPPRESS_WARNINGS
+#include <boost/assert.hpp>
+#include <boost/functional/hash.hpp>
+RESTORE_WARNINGS
+
+#include <algorithm>
+
+namespace aqt
+{
+namespace stylesheets
+{
+
+PathNode::PathNode()
+  : mpParent(nullptr)
+  , mElement(std::string())
+  , mDepth(0)
+  , mElementHash(0)
+  , mHash(0)
+{
+}
+
+PathNode::PathNode(const PathNode* pParent,
+                   const PathElement& element,
+                   std::size_t elementHash)
+  : mpParent(pParent)
+  , mElement(element)
+  , mDepth(pParent->mDepth + 1)
+  , mElementHash(elementHash)
+  , mHash(pParent->mHash)
+{
+  boost::hash_combine(mHash, elementHash);
+}
+
+const PathNode* PathNode::parent() const
+{
+  return mpParent;
+}
+
+const PathElement& PathNode::element() const
+{
+  BOOST_ASSERT(mpParent);
+  return mElement;
+}
+
+std::size_t PathNode::depth() const
+{
+  return mDepth;
+}
+
+std::size_t PathNode::hash() const
+{
+  return mHash;
+}
+
+std::size_t PathNode::elementHash() const
+{
+  return mElementHash;
+}
+
+UiItemPath PathNode::path() const
+{
+  UiItemPath result;
+  result.reserve(mDepth);
+
+  for (auto* pNode = this; pNode->mpParent; pNode = pNode->mpParent) {
+    result.push_back(pNode->mElement);
+  }
+  std::reverse(result.begin(), result.end());
+
+  return result;
+}
+
+PathTrie::PathTrie()
+  : mpRoot(new PathNode())
+  , mSize(1)
+{
+}
+
+const PathNode* PathTrie::root() const
+{
+  return mpRoot.get();
+}
+
+const PathNode* PathTrie::intern(const PathNode* pParent, const PathElement& element)
+{
+  return intern(pParent, element, hash_value(element));
+}
+
+const PathNode* PathTrie::intern(const PathNode* pParent,
+                                 const PathElement& element,
+                                 std::size_t elementHash)
+{
+  BOOST_ASSERT(pParent);
+  BOOST_ASSERT(elementHash == hash_value(element));
+
+  const auto range = pParent->mChildren.equal_range(elementHash);
+
+  for (auto iChild = range.first; iChild != range.second; ++iChild) {
+    if (iChild->second->mElement == element) {
+      return iChild->second.get();
+    }
+  }
+
+  auto pChild = std::unique_ptr<PathNode>(new PathNode(pParent, element, elementHash));
+  ++mSize;
+
+  return pParent->mChildren.emplace(elementHash, std::move(pChild))->second.get();
+}
+
+const PathNode* PathTrie::intern(const UiItemPath& path)
+{
+  auto* pNode = root();
+  for (const auto& element : path) {
+    pNode = intern(pNode, element);
+  }
+  return pNode;
+}
+
+const PathNode* PathTrie::concat(const PathNode* pPrefix, const PathNode* pSuffix)
+{
+  BOOST_ASSERT(pPrefix);
+  BOOST_ASSERT(pSuffix);
+
+  if (!pSuffix->mpParent) {
+    return pPrefix;
+  }
+
+  return intern(concat(pPrefix, pSuffix->mpParent), pSuffix->mElement,
+                pSuffix->mElementHash);
+}
+
+std::size_t PathTrie::size() const
+{
+  return mSize;
+}
+
+std::string pathToString(const PathNode* pPath)
+{
+  return pPath ? pathToString(pPath->path()) : std::string();
+}
+
+} // namespace stylesheets
+} // namespace aqt
@@ -0,0 +1,133 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "StyleMatchTree.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+/*! @cond DOXYGEN_IGNORE */
+
+namespace aqt
+{
+namespace stylesheets
+{
+
+/*! An interned UiItemPath
+ *
+ * Each unique path exists exactly once as a node in a PathTrie.  A node
+ * knows its parent node (the path without its last element) and its own
+ * last path element.  Two paths are equal if and only if their nodes are
+ * identical, which makes comparing and hashing paths O(1).
+ */
+class PathNode
+{
+public:
+  PathNode(const PathNode&) = delete;
+  PathNode& operator=(const PathNode&) = delete;
+
+  /*! Returns the path without the last element; nullptr for the root node */
+  const PathNode* parent() const;
+
+  /*! Returns the last element of the path; must not be called on the root */
+  const PathElement& element() const;
+
+  /*! Returns the number of path elements; 0 for the root node */
+  std::size_t depth() const;
+
+  /*! Returns the (precomputed) hash value of the complete path */
+  std::size_t hash() const;
+
+  /*! Returns the (precomputed) hash value of the last element only */
+  std::size_t elementHash() const;
+
+  /*! Returns the complete path from the root to this node */
+  UiItemPath path() const;
+
+private:
+  friend class PathTrie;
+
+  PathNode();
+  PathNode(const PathNode* pParent, const PathElement& element, std::size_t elementHash);
+
+  const PathNode* mpParent;
+  PathElement mElement;
+  std::size_t mDepth;
+  std::size_t mElementHash;
+  std::size_t mHash;
+
+  // owned by the node, but only ever modified by PathTrie::intern()
+  using Children = std::unordered_multimap<std::size_t, std::unique_ptr<PathNode>>;
+  mutable Children mChildren;
+};
+
+/*! Owns and interns PathNodes
+ *
+ * Nodes are never removed from the trie; pointers to nodes stay valid as
+ * long as the trie exists.
+ */
+class PathTrie
+{
+public:
+  PathTrie();
+  PathTrie(const PathTrie&) = delete;
+  PathTrie& operator=(const PathTrie&) = delete;
+
+  /*! Returns the node for the empty path */
+  const PathNode* root() const;
+
+  /*! Returns the node for @p pParent's path extended by @p element */
+  const PathNode* intern(const PathNode* pParent, const PathElement& element);
+
+  /*! Same as above, but with the precomputed @p elementHash of @p element */
+  const PathNode* intern(const PathNode* pParent,
+                         const PathElement& element,
+                         std::size_t elementHash);
+
+  /*! Returns the node for @p path */
+  const PathNode* intern(const UiItemPath& path);
+
+  /*! Returns the node for @p pSuffix's path appended to @p pPrefix's path
+   *
+   * This allows to keep a path relative to some other path as a node of its
+   * own, with the root node standing in for the other path.
+   */
+  const PathNode* concat(const PathNode* pPrefix, const PathNode* pSuffix);
+
+  /*! Returns the number of nodes (including the root) */
+  std::size_t size() const;
+
+private:
+  std::unique_ptr<PathNode> mpRoot;
+  std::size_t mSize;
+};
+
+std::string pathToString(const PathNode* pPath);
+
+} // namespace stylesheets
+} // namespace aqt
+
+/*! @endcond */
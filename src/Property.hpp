@@ -42,6 +42,11 @@ namespace stylesheets
 class Expression
 {
 public:
+  bool operator==(const Expression& other) const
+  {
+    return name == other.name && args == other.args;
+  }
+
   std::string name;
   std::vector<std::string> args;
 };
@@ -0,0 +1,429 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "StyleCache.hpp"
+
+#include "estd/memory.hpp"
+#include "Warnings.hpp"
+
+SUPPRESS_WARNINGS
+#include <QtCore/QByteArray>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <boost/variant/get.hpp>
+RESTORE_WARNINGS
+
+#include <cstring>
+#include <functional>
+#include <utility>
+
+namespace aqt
+{
+namespace stylesheets
+{
+namespace
+{
+
+// "AQSC" followed by the format version and the file size, which catches
+// truncated files; the cache is written in the native byte order, a cache
+// from a machine of different endianness is not accepted
+const std::uint32_t kMagic = 0x43535141;
+const std::uint32_t kVersion = 1;
+
+const std::uint32_t kNotCached = 0xffffffff;
+
+enum ValueKind : std::uint32_t { kStringValue = 0, kExpressionValue = 1 };
+
+class CorruptStyleCache
+{
+};
+
+class Writer
+{
+public:
+  void u32(std::uint32_t value)
+  {
+    mData.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  void i32(int value)
+  {
+    u32(static_cast<std::uint32_t>(value));
+  }
+
+  void string(const std::string& str)
+  {
+    u32(static_cast<std::uint32_t>(str.size()));
+    mData.append(str);
+  }
+
+  //! Reserves room for a value filled in later by patchU32()
+  std::size_t placeholderU32()
+  {
+    const auto pos = mData.size();
+    u32(0);
+    return pos;
+  }
+
+  void patchU32(std::size_t pos, std::uint32_t value)
+  {
+    std::memcpy(&mData[pos], &value, sizeof(value));
+  }
+
+  std::size_t pos() const
+  {
+    return mData.size();
+  }
+
+  std::string mData;
+};
+
+/*! Reads from a style cache, throwing CorruptStyleCache on reading past its end */
+class Reader
+{
+public:
+  Reader(const char* pData, std::size_t size, std::size_t pos = 0)
+    : mpData(pData)
+    , mSize(size)
+    , mPos(pos)
+  {
+  }
+
+  std::uint32_t u32()
+  {
+    auto value = std::uint32_t{};
+    std::memcpy(&value, take(sizeof(value)), sizeof(value));
+    return value;
+  }
+
+  int i32()
+  {
+    return static_cast<int>(u32());
+  }
+
+  std::string string()
+  {
+    const auto size = u32();
+    return std::string(take(size), size);
+  }
+
+private:
+  const char* take(std::size_t size)
+  {
+    if (size > mSize - mPos) {
+      throw CorruptStyleCache();
+    }
+
+    const auto* pResult = mpData + mPos;
+    mPos += size;
+    return pResult;
+  }
+
+  const char* mpData;
+  std::size_t mSize;
+  std::size_t mPos;
+};
+
+void writePropertyMap(Writer& writer, const PropertyMap& props)
+{
+  writer.u32(static_cast<std::uint32_t>(props.size()));
+
+  for (const auto& entry : props) {
+    const auto name = entry.first.toUtf8();
+    writer.string(std::string(name.constData(), static_cast<std::size_t>(name.size())));
+
+    const auto& loc = entry.second.mSourceLoc;
+    writer.i32(loc.mSourceLayer);
+    writer.i32(loc.mByteOfs);
+    writer.i32(loc.mLine);
+    writer.i32(loc.mColumn);
+
+    writer.u32(static_cast<std::uint32_t>(entry.second.mValues.size()));
+    for (const auto& value : entry.second.mValues) {
+      if (const auto* pString = boost::get<std::string>(&value)) {
+        writer.u32(kStringValue);
+        writer.string(*pString);
+      } else {
+        const auto& expr = boost::get<Expression>(value);
+        writer.u32(kExpressionValue);
+        writer.string(expr.name);
+        writer.u32(static_cast<std::uint32_t>(expr.args.size()));
+        for (const auto& arg : expr.args) {
+          writer.string(arg);
+        }
+      }
+    }
+  }
+}
+
+PropertyMap readPropertyMap(Reader& reader)
+{
+  PropertyMap::Entries entries;
+
+  const auto count = reader.u32();
+  for (auto i = std::uint32_t{0}; i < count; ++i) {
+    const auto name = reader.string();
+
+    SourceLocation loc;
+    loc.mSourceLayer = reader.i32();
+    loc.mByteOfs = reader.i32();
+    loc.mLine = reader.i32();
+    loc.mColumn = reader.i32();
+
+    PropertyValues values;
+    const auto valueCount = reader.u32();
+    for (auto j = std::uint32_t{0}; j < valueCount; ++j) {
+      const auto kind = reader.u32();
+      if (kind == kStringValue) {
+        values.emplace_back(reader.string());
+      } else if (kind == kExpressionValue) {
+        Expression expr;
+        expr.name = reader.string();
+        const auto argCount = reader.u32();
+        for (auto k = std::uint32_t{0}; k < argCount; ++k) {
+          expr.args.push_back(reader.string());
+        }
+        values.emplace_back(std::move(expr));
+      } else {
+        throw CorruptStyleCache();
+      }
+    }
+
+    entries.emplace_back(QString::fromUtf8(name.data(), static_cast<int>(name.size())),
+                         Property(loc, values));
+  }
+
+  return PropertyMap(std::move(entries));
+}
+
+} // anon namespace
+
+StyleCache::StyleCache(const char* pData, std::size_t size)
+  : mpData(pData)
+  , mSize(size)
+{
+}
+
+StyleCache::~StyleCache() = default;
+
+std::unique_ptr<StyleCache> StyleCache::open(const QString& path,
+                                             const std::string& key,
+                                             PathTrie& pathTrie)
+{
+  auto pFile = estd::make_unique<QFile>(path);
+  if (!pFile->exists() || !pFile->open(QIODevice::ReadOnly)) {
+    return nullptr;
+  }
+
+  const auto size = pFile->size();
+  const auto* pData = size > 0 ? pFile->map(0, size) : nullptr;
+  if (!pData) {
+    return nullptr;
+  }
+
+  auto pCache = fromData(
+    reinterpret_cast<const char*>(pData), static_cast<std::size_t>(size), key, pathTrie);
+  if (pCache) {
+    // the mapping lives as long as the file object
+    pCache->mpFile = std::move(pFile);
+  }
+
+  return pCache;
+}
+
+std::unique_ptr<StyleCache> StyleCache::fromData(const char* pData,
+                                                 std::size_t size,
+                                                 const std::string& key,
+                                                 PathTrie& pathTrie)
+{
+  auto pCache = std::unique_ptr<StyleCache>(new StyleCache(pData, size));
+
+  try {
+    auto reader = Reader(pData, size);
+    if (reader.u32() != kMagic || reader.u32() != kVersion || reader.u32() != size
+        || reader.string() != key) {
+      return nullptr;
+    }
+
+    const auto mapCount = reader.u32();
+    for (auto i = std::uint32_t{0}; i < mapCount; ++i) {
+      const auto offset = reader.u32();
+      if (offset >= size) {
+        throw CorruptStyleCache();
+      }
+      pCache->mMapOffsets.push_back(offset);
+    }
+    pCache->mDecodedMaps.resize(mapCount);
+
+    // paths are stored parents first, each referring to its parent by index
+    auto nodes = std::vector<const PathNode*>{pathTrie.root()};
+
+    const auto pathCount = reader.u32();
+    for (auto i = std::uint32_t{0}; i < pathCount; ++i) {
+      const auto parent = reader.u32();
+      const auto typeName = reader.string();
+
+      std::vector<std::string> classNames;
+      const auto classCount = reader.u32();
+      for (auto j = std::uint32_t{0}; j < classCount; ++j) {
+        classNames.push_back(reader.string());
+      }
+
+      const auto mapIndex = reader.u32();
+      if (parent >= nodes.size() || (mapIndex != kNotCached && mapIndex >= mapCount)) {
+        throw CorruptStyleCache();
+      }
+
+      const auto* pNode =
+        pathTrie.intern(nodes[parent], PathElement(typeName, classNames));
+      nodes.push_back(pNode);
+
+      if (mapIndex != kNotCached) {
+        pCache->mPathMaps.emplace(pNode, mapIndex);
+      }
+    }
+  } catch (const CorruptStyleCache&) {
+    return nullptr;
+  }
+
+  return pCache;
+}
+
+std::shared_ptr<PropertyMap> StyleCache::properties(const PathNode* pPath) const
+{
+  const auto iPath = mPathMaps.find(pPath);
+  if (iPath == mPathMaps.end()) {
+    return nullptr;
+  }
+
+  auto& pProps = mDecodedMaps[iPath->second];
+  if (!pProps) {
+    try {
+      auto reader = Reader(mpData, mSize, mMapOffsets[iPath->second]);
+      pProps = std::make_shared<PropertyMap>(readPropertyMap(reader));
+    } catch (const CorruptStyleCache&) {
+      return nullptr;
+    }
+  }
+
+  return pProps;
+}
+
+bool StyleCache::contains(const PathNode* pPath) const
+{
+  return mPathMaps.count(pPath) > 0;
+}
+
+std::size_t StyleCache::size() const
+{
+  return mPathMaps.size();
+}
+
+std::string serializeStyleCache(const std::string& key,
+                                const StyleCache::PropertyMaps& propertyMaps)
+{
+  // number the paths parents first and the distinct property maps
+  std::unordered_map<const PathNode*, std::uint32_t> pathIndices;
+  std::vector<const PathNode*> paths;
+  std::function<std::uint32_t(const PathNode*)> pathIndex = [&](const PathNode* pPath) {
+    if (pPath->depth() == 0) {
+      return std::uint32_t{0};
+    }
+
+    const auto iPath = pathIndices.find(pPath);
+    if (iPath != pathIndices.end()) {
+      return iPath->second;
+    }
+
+    pathIndex(pPath->parent());
+    paths.push_back(pPath);
+    pathIndices.emplace(pPath, static_cast<std::uint32_t>(paths.size()));
+    return static_cast<std::uint32_t>(paths.size());
+  };
+
+  std::unordered_map<const PropertyMap*, std::uint32_t> mapIndices;
+  std::vector<const PropertyMap*> maps;
+
+  for (const auto& element : propertyMaps) {
+    pathIndex(element.first);
+
+    if (mapIndices.emplace(element.second.get(), maps.size()).second) {
+      maps.push_back(element.second.get());
+    }
+  }
+
+  Writer writer;
+  writer.u32(kMagic);
+  writer.u32(kVersion);
+  const auto sizePosition = writer.placeholderU32();
+  writer.string(key);
+
+  writer.u32(static_cast<std::uint32_t>(maps.size()));
+  std::vector<std::size_t> offsetPositions;
+  for (std::size_t i = 0; i < maps.size(); ++i) {
+    offsetPositions.push_back(writer.placeholderU32());
+  }
+
+  writer.u32(static_cast<std::uint32_t>(paths.size()));
+  for (const auto* pPath : paths) {
+    const auto& element = pPath->element();
+
+    writer.u32(pathIndex(pPath->parent()));
+    writer.string(element.mTypeName);
+    writer.u32(static_cast<std::uint32_t>(element.mClassNames.size()));
+    for (const auto& className : element.mClassNames) {
+      writer.string(className);
+    }
+
+    const auto iProps = propertyMaps.find(pPath);
+    writer.u32(iProps != propertyMaps.end() ? mapIndices[iProps->second.get()]
+                                            : kNotCached);
+  }
+
+  for (std::size_t i = 0; i < maps.size(); ++i) {
+    writer.patchU32(offsetPositions[i], static_cast<std::uint32_t>(writer.pos()));
+    writePropertyMap(writer, *maps[i]);
+  }
+  writer.patchU32(sizePosition, static_cast<std::uint32_t>(writer.pos()));
+
+  return std::move(writer.mData);
+}
+
+bool writeStyleCache(const QString& path,
+                     const std::string& key,
+                     const StyleCache::PropertyMaps& propertyMaps)
+{
+  const auto data = serializeStyleCache(key, propertyMaps);
+
+  QDir().mkpath(QFileInfo(path).absolutePath());
+
+  QSaveFile file(path);
+  return file.open(QIODevice::WriteOnly)
+         && file.write(data.data(), static_cast<qint64>(data.size()))
+              == static_cast<qint64>(data.size())
+         && file.commit();
+}
+
+} // namespace stylesheets
+} // namespace aqt
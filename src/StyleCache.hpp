@@ -0,0 +1,124 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "PathTrie.hpp"
+#include "StyleMatchTree.hpp"
+
+#include "Warnings.hpp"
+
+SUPPRESS_WARNINGS
+#include <QtCore/QString>
+RESTORE_WARNINGS
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class QFile;
+
+/*! @cond DOXYGEN_IGNORE */
+
+namespace aqt
+{
+namespace stylesheets
+{
+
+/*! A persistent cache of effective property maps
+ *
+ * An application resolves the properties of the same paths on every start.
+ * A style cache file stores the effective property maps of all paths resolved
+ * in one session, together with a key identifying the style sheets they have
+ * been resolved from.  A later session using the same style sheets maps the
+ * file into memory and decodes property maps from it on first use instead of
+ * matching their paths again.
+ */
+class StyleCache
+{
+public:
+  using PropertyMaps = std::unordered_map<const PathNode*, std::shared_ptr<PropertyMap>>;
+
+  /*! Maps the cache file at @p path
+   *
+   * Returns nullptr if the file does not exist, is damaged or has been
+   * written for another @p key.  The paths of all cached property maps are
+   * interned into @p pathTrie.
+   */
+  static std::unique_ptr<StyleCache> open(const QString& path,
+                                          const std::string& key,
+                                          PathTrie& pathTrie);
+
+  /*! Same as above, reading from @p pData which must outlive the cache */
+  static std::unique_ptr<StyleCache> fromData(const char* pData,
+                                              std::size_t size,
+                                              const std::string& key,
+                                              PathTrie& pathTrie);
+
+  StyleCache(const StyleCache&) = delete;
+  StyleCache& operator=(const StyleCache&) = delete;
+  ~StyleCache();
+
+  /*! Returns the cached properties for @p pPath; nullptr if it is not cached */
+  std::shared_ptr<PropertyMap> properties(const PathNode* pPath) const;
+
+  /*! Returns whether the properties for @p pPath are cached */
+  bool contains(const PathNode* pPath) const;
+
+  /*! Returns the number of cached paths */
+  std::size_t size() const;
+
+private:
+  StyleCache(const char* pData, std::size_t size);
+
+  std::unique_ptr<QFile> mpFile;
+  const char* mpData;
+  std::size_t mSize;
+  std::vector<std::uint32_t> mMapOffsets;
+  std::unordered_map<const PathNode*, std::uint32_t> mPathMaps;
+  // property maps shared by several paths are decoded only once
+  mutable std::vector<std::shared_ptr<PropertyMap>> mDecodedMaps;
+};
+
+/*! Returns the contents of a style cache file for @p propertyMaps */
+std::string serializeStyleCache(const std::string& key,
+                                const StyleCache::PropertyMaps& propertyMaps);
+
+/*! Writes a style cache file for @p propertyMaps to @p path
+ *
+ * The file is replaced atomically.  Does not touch any state shared with
+ * other threads but the (immutable) path nodes and property maps, so it can
+ * run on a background thread.
+ *
+ * @return false if the file could not be written
+ */
+bool writeStyleCache(const QString& path,
+                     const std::string& key,
+                     const StyleCache::PropertyMaps& propertyMaps);
+
+} // namespace stylesheets
+} // namespace aqt
+
+/*! @endcond */
@@ -22,26 +22,34 @@ THE SOFTWARE.
 
 #include "StyleEngine.hpp"
 
-#include "estd/memory.hpp"
+#include "Convert.hpp"
 #include "CssParser.hpp"
 #include "Log.hpp"
 #include "StyleMatchTree.hpp"
+#include "Trace.hpp"
 #include "UrlUtils.hpp"
 #include "Warnings.hpp"
 
 SUPPRESS_WARNINGS
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 #include <QtCore/QUrl>
 #include <QtGui/QFontDatabase>
 #include <QtQml/QQmlEngine>
 #include <QtQml/QQmlFile>
 RESTORE_WARNINGS
 
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <map>
 #include <memory>
 #include <tuple>
+#include <unordered_set>
 
 namespace aqt
 {
@@ -51,6 +59,20 @@ namespace stylesheets
 namespace
 {
 
+const std::size_t kMinStyleSetPropsCollectionSize = 64;
+
+//! take a new snapshot once the engine resolved twice this many paths
+const std::size_t kMinSnapshotPropertyMapCount = 64;
+
+//! drop the cached type elements when reaching this number of entries
+const std::size_t kMaxTypeElementCount = 1024;
+
+#if defined(AQT_STYLESHEETS_COUNTING_DIAGNOSTICS) && !defined(DEBUG)
+const auto kDefaultDiagnostics = StyleEngine::Diagnostics::Counting;
+#else
+const auto kDefaultDiagnostics = StyleEngine::Diagnostics::Full;
+#endif
+
 using FontIdCache = std::map<QString, int>;
 
 FontIdCache& fontIdCache()
@@ -59,14 +81,154 @@ FontIdCache& fontIdCache()
   return sFontIdCache;
 }
 
+std::string normalizeTypename(const std::string& tynm)
+{
+  size_t pos = tynm.find("_QMLTYPE_");
+  if (pos != std::string::npos) {
+    return tynm.substr(0, pos);
+  }
+
+  pos = tynm.find("_QML_");
+  if (pos != std::string::npos) {
+    return tynm.substr(0, pos);
+  }
+  return tynm;
+}
+
 std::unique_ptr<StyleEngine>& instanceImpl()
 {
   static std::unique_ptr<StyleEngine> spInstance;
   return spInstance;
 }
 
+using PropertyMapCache =
+  std::unordered_map<const PathNode*, std::shared_ptr<PropertyMap>>;
+
+std::shared_ptr<PropertyMap> matchPropertyMap(const IStyleMatchTree* pStyleTree,
+                                              const PathNode* pPath,
+                                              PropertyMapCache& propertyMaps,
+                                              const StyleCache* pStyleCache = nullptr,
+                                              IMatchProfile* pProfile = nullptr)
+{
+  const auto iElement = propertyMaps.find(pPath);
+  if (iElement != propertyMaps.end()) {
+    return iElement->second;
+  }
+
+  if (pStyleCache) {
+    if (auto pCachedProps = pStyleCache->properties(pPath)) {
+      propertyMaps.emplace(pPath, pCachedProps);
+      return pCachedProps;
+    }
+  }
+
+  auto props = matchPath(pStyleTree, pPath->path(), pProfile);
+
+  if (pPath->depth() > 1) {
+    auto pAncestorProps = matchPropertyMap(
+      pStyleTree, pPath->parent(), propertyMaps, pStyleCache, pProfile);
+
+    if (props.empty()) {
+      // point to our ancestor props and return them immediately
+      // without storing our own props instance
+      propertyMaps.emplace(pPath, pAncestorProps);
+      return pAncestorProps;
+    } else {
+      props = mergeInheritedProperties(props, *pAncestorProps);
+    }
+  }
+
+  auto pProps = std::make_shared<PropertyMap>(std::move(props));
+  propertyMaps.emplace(pPath, pProps);
+
+  return pProps;
+}
+
+//! Returns a predicate telling whether a path is matched by any of @p rules
+std::function<bool(const UiItemPath&)> matchedByAnyOf(
+  const std::vector<StyleSheet>& rules)
+{
+  if (rules.empty()) {
+    return [](const UiItemPath&) { return false; };
+  }
+
+  std::vector<const StyleSheet*> layers;
+  for (const auto& styleSheet : rules) {
+    layers.push_back(&styleSheet);
+  }
+
+  const auto pRulesTree = std::shared_ptr<const IStyleMatchTree>(createMatchTree(layers));
+  const auto layerCount = layers.size();
+
+  return [pRulesTree, layerCount](const UiItemPath& path) {
+    for (std::size_t layer = 0; layer < layerCount; ++layer) {
+      if (isPathMatchedByLayer(pRulesTree.get(), layer, path)) {
+        return true;
+      }
+    }
+    return false;
+  };
+}
+
+/*! Tells whether a path is touched itself or through any of its ancestors
+ *
+ * Property maps inherit from their ancestors' maps, so a path is affected by
+ * a change touching one of its ancestors, too.  The results are memoized.
+ */
+class AffectedPaths
+{
+public:
+  explicit AffectedPaths(std::function<bool(const UiItemPath&)> isTouched)
+    : mIsTouched(std::move(isTouched))
+  {
+  }
+
+  bool operator()(const PathNode* pPath)
+  {
+    const auto iAffected = mAffectedPaths.find(pPath);
+    if (iAffected != mAffectedPaths.end()) {
+      return iAffected->second;
+    }
+
+    const auto result =
+      (pPath->depth() > 1 && (*this)(pPath->parent())) || mIsTouched(pPath->path());
+
+    mAffectedPaths.emplace(pPath, result);
+    return result;
+  }
+
+private:
+  std::function<bool(const UiItemPath&)> mIsTouched;
+  std::unordered_map<const PathNode*, bool> mAffectedPaths;
+};
+
+//! Removes the maps of the paths @p isAffected tells from @p propertyMaps
+PropertyMapCache takeAffectedPropertyMaps(
+  PropertyMapCache& propertyMaps, const std::function<bool(const PathNode*)>& isAffected)
+{
+  auto result = PropertyMapCache{};
+  for (auto iElement = propertyMaps.begin(); iElement != propertyMaps.end();) {
+    if (isAffected(iElement->first)) {
+      result.emplace(*iElement);
+      iElement = propertyMaps.erase(iElement);
+    } else {
+      ++iElement;
+    }
+  }
+
+  return result;
+}
+
 } // anon namespace
 
+StyleEngine::StyleEngine()
+  : mLayers(2)
+  , mpPathTrie(std::make_shared<PathTrie>())
+  , mStyleSetPropsCollectionSize(kMinStyleSetPropsCollectionSize)
+  , mDiagnostics(kDefaultDiagnostics)
+{
+}
+
 StyleEngine& StyleEngine::instance()
 {
   if (!instanceImpl()) {
@@ -92,6 +254,8 @@ bool StyleEngine::hasStylesLoaded() const
 
 void StyleEngine::unloadStyles()
 {
+  saveStyleCache();
+
   mHasStylesLoaded = false;
 
   for (auto& element : mStyleSetPropsRefs) {
@@ -100,45 +264,342 @@ void StyleEngine::unloadStyles()
   }
 
   mPropertyMaps.clear();
-  mPropertyMapInstances.clear();
+  mpSnapshot.reset();
+
+  for (auto& layer : mLayers) {
+    layer.mStyleSheet = ParsedStyleSheet{};
+  }
+  clearPreloadedStyleSheets();
 
-  mpStyleTree = createMatchTree({});
+  mOverrides.clear();
+  mpOverrides.reset();
+
+  mpStyleTree = createMatchTree(StyleSheet());
 }
 
 QUrl StyleEngine::styleSheetSource() const
 {
-  return mStyleSheetSourceUrl;
+  return mLayers.back().mSourceUrl;
 }
 
 void StyleEngine::setStyleSheetSource(const QUrl& url)
 {
-  if (mStyleSheetSourceUrl != url) {
-    mStyleSheetSourceUrl = url;
-  }
+  mLayers.back().mSourceUrl = url;
 }
 
 QUrl StyleEngine::defaultStyleSheetSource() const
 {
-  return mDefaultStyleSheetSourceUrl;
+  return mLayers.front().mSourceUrl;
 }
 
 void StyleEngine::setDefaultStyleSheetSource(const QUrl& url)
 {
-  if (mDefaultStyleSheetSourceUrl != url) {
-    mDefaultStyleSheetSourceUrl = url;
+  mLayers.front().mSourceUrl = url;
+}
+
+QList<QUrl> StyleEngine::styleSheetLayerSources() const
+{
+  QList<QUrl> result;
+  for (auto i = std::size_t(1); i + 1 < mLayers.size(); ++i) {
+    result.append(mLayers[i].mSourceUrl);
+  }
+
+  return result;
+}
+
+void StyleEngine::setStyleSheetLayerSources(const QList<QUrl>& urls)
+{
+  const auto layerCount = static_cast<std::size_t>(urls.size()) + 2;
+
+  if (layerCount != mLayers.size()) {
+    auto userLayer = std::move(mLayers.back());
+    mLayers.resize(layerCount - 1);
+    mLayers.emplace_back(std::move(userLayer));
+  }
+
+  for (auto i = 0; i < urls.size(); ++i) {
+    mLayers[static_cast<std::size_t>(i) + 1].mSourceUrl = urls[i];
+  }
+}
+
+std::size_t StyleEngine::styleSheetLayerCount() const
+{
+  return mLayers.size();
+}
+
+QUrl StyleEngine::styleSheetLayerSource(std::size_t layer) const
+{
+  return layer < mLayers.size() ? mLayers[layer].mSourceUrl : QUrl();
+}
+
+std::vector<std::string> StyleEngine::layerNames() const
+{
+  std::vector<std::string> layerNames;
+  for (std::size_t layer = 0; layer < mLayers.size(); ++layer) {
+    if (layer == 0) {
+      layerNames.emplace_back("default stylesheet");
+    } else if (layer + 1 == mLayers.size()) {
+      layerNames.emplace_back("user stylesheet");
+    } else {
+      layerNames.emplace_back("stylesheet layer " + std::to_string(layer));
+    }
+  }
+  layerNames.emplace_back("overrides");
+
+  return layerNames;
+}
+
+std::string StyleEngine::describeMatchedPath(const PathNode* pPath) const
+{
+  return aqt::stylesheets::describeMatchedPath(
+    mpStyleTree.get(), pPath->path(), layerNames());
+}
+
+void StyleEngine::setProfiling(bool isProfiling)
+{
+  if (isProfiling != profiling()) {
+    mpMatchProfile = isProfiling ? createMatchProfile() : nullptr;
   }
 }
 
-std::string StyleEngine::describeMatchedPath(const UiItemPath& path) const
+bool StyleEngine::profiling() const
 {
-  return aqt::stylesheets::describeMatchedPath(mpStyleTree.get(), path);
+  return mpMatchProfile != nullptr;
 }
 
-void StyleEngine::resolveFontFaceDecl(const StyleSheet& styleSheet)
+std::string StyleEngine::matchProfile() const
 {
+  if (!mpMatchProfile) {
+    return {};
+  }
+
+  return matchProfileToJson(mpMatchProfile.get(), mpStyleTree.get(), layerNames());
+}
+
+bool StyleEngine::setOverride(const QString& selector,
+                              const QString& property,
+                              const QString& value)
+{
+  auto newOverride = Override{selector.toStdString(), property.toStdString(),
+                              value.toStdString()};
+
+  StyleSheet changedRules;
+  try {
+    changedRules = parseStdString(overrideSource(newOverride));
+  } catch (const ParseException& e) {
+    styleSheetsLogError() << e.message() << ": " << e.errorContext();
+  }
+
+  if (changedRules.propsets.size() != 1
+      || changedRules.propsets[0].properties.size() != 1
+      || changedRules.propsets[0].properties[0].name != newOverride.mProperty) {
+    styleSheetsLogWarning() << "Invalid override '" << overrideSource(newOverride) << "'";
+
+    Q_EMIT exception(QString::fromLatin1("invalidOverride"),
+                     QString::fromLatin1("Invalid override '%1 { %2: %3 }'.")
+                       .arg(selector, property, value));
+    return false;
+  }
+
+  const auto iOverride =
+    std::find_if(mOverrides.begin(), mOverrides.end(), [&](const Override& other) {
+      return other.mSelector == newOverride.mSelector
+             && other.mProperty == newOverride.mProperty;
+    });
+
+  if (iOverride == mOverrides.end()) {
+    mOverrides.emplace_back(std::move(newOverride));
+  } else if (iOverride->mValue != newOverride.mValue) {
+    iOverride->mValue = newOverride.mValue;
+  } else {
+    return true;
+  }
+
+  updateOverrides(changedRules);
+  return true;
+}
+
+void StyleEngine::clearOverride(const QString& selector, const QString& property)
+{
+  const auto iOverride =
+    std::find_if(mOverrides.begin(), mOverrides.end(), [&](const Override& other) {
+      return other.mSelector == selector.toStdString()
+             && other.mProperty == property.toStdString();
+    });
+
+  if (iOverride != mOverrides.end()) {
+    const auto changedRules = parseStdString(overrideSource(*iOverride));
+    mOverrides.erase(iOverride);
+
+    updateOverrides(changedRules);
+  }
+}
+
+void StyleEngine::clearOverrides()
+{
+  if (!mOverrides.empty()) {
+    const auto pChangedRules = mpOverrides;
+    mOverrides.clear();
+
+    updateOverrides(*pChangedRules);
+  }
+}
+
+std::string StyleEngine::overrideSource(const Override& entry)
+{
+  return entry.mSelector + " { " + entry.mProperty + ": " + entry.mValue + "; }";
+}
+
+void StyleEngine::updateOverrides(const StyleSheet& changedRules)
+{
+  std::string source;
+  for (const auto& entry : mOverrides) {
+    source += overrideSource(entry) + "\n";
+  }
+
+  // all overrides have been checked to parse on their own
+  const auto pOldOverrides = mpOverrides;
+  mpOverrides = std::make_shared<const StyleSheet>(parseStdString(source));
+
+  // otherwise the overrides are picked up by the next load
+  if (isStyleTreeComplete()) {
+    const auto overridesLayer = mLayers.size();
+    mpStyleTree = replaceMatchTreeLayer(mpStyleTree.get(), overridesLayer, *mpOverrides);
+    mpStyleCache.reset();
+
+    // only paths matched by the changed rules need to be looked at again;
+    // removing an override moves the ones following it
+    const auto movedRules =
+      pOldOverrides ? movedPropsets(*pOldOverrides, *mpOverrides) : StyleSheet();
+    reloadTouchedProperties(
+      std::vector<StyleSheet>{changedRules}, std::vector<StyleSheet>{movedRules});
+
+    // the preloaded style sheets get the new overrides once switched to, see
+    // updatePreloadedOverrides()
+
+    Q_EMIT styleChanged();
+  }
+}
+
+void StyleEngine::setStyleCacheSource(const QUrl& url)
+{
+  mStyleCacheSourceUrl = url;
+}
+
+QUrl StyleEngine::styleCacheSource() const
+{
+  return mStyleCacheSourceUrl;
+}
+
+std::string StyleEngine::styleCacheKey() const
+{
+  std::string key;
+  for (const auto& layer : mLayers) {
+    const auto& parsed = layer.mStyleSheet;
+    key += parsed.mPath.toStdString() + '\n';
+    key.append(parsed.mContentHash.constData(),
+               static_cast<std::size_t>(parsed.mContentHash.size()));
+    key += '\n';
+  }
+
+  for (const auto& entry : mOverrides) {
+    key += overrideSource(entry) + '\n';
+  }
+
+  return key;
+}
+
+void StyleEngine::openStyleCache()
+{
+  if (mStyleCacheSourceUrl.isEmpty()) {
+    return;
+  }
+
+  const auto path = mBaseUrl.resolved(mStyleCacheSourceUrl).toLocalFile();
+
+  // a write still running from an earlier session might replace the file
+  if (mPendingStyleCacheWrite.valid()) {
+    mPendingStyleCacheWrite.wait();
+  }
+
+  mpStyleCache = StyleCache::open(path, styleCacheKey(), *mpPathTrie);
+  if (mpStyleCache) {
+    styleSheetsLogInfo() << "Use style cache '" << path.toStdString() << "' with "
+                         << mpStyleCache->size() << " paths";
+  }
+}
+
+void StyleEngine::saveStyleCache()
+{
+  if (mStyleCacheSourceUrl.isEmpty() || !mHasStylesLoaded || mPropertyMaps.empty()) {
+    return;
+  }
+
+  const auto isCached = [this](const PropertyMaps::value_type& element) {
+    return mpStyleCache && mpStyleCache->contains(element.first);
+  };
+  if (std::all_of(mPropertyMaps.begin(), mPropertyMaps.end(), isCached)) {
+    return;
+  }
+
+  // release the mapping of the file about to be replaced
+  mpStyleCache.reset();
+
+  // path nodes and property maps are immutable; the trie is kept alive for
+  // the nodes while writing
+  const auto path = mBaseUrl.resolved(mStyleCacheSourceUrl).toLocalFile();
+  mPendingStyleCacheWrite =
+    std::async(std::launch::async,
+               [path](std::string key, PropertyMaps propertyMaps,
+                      std::shared_ptr<const PathTrie>) {
+                 if (!writeStyleCache(path, key, propertyMaps)) {
+                   styleSheetsLogWarning() << "Writing style cache '"
+                                           << path.toStdString() << "' failed";
+                 }
+               },
+               styleCacheKey(), mPropertyMaps, mpPathTrie);
+}
+
+bool StyleEngine::isStyleTreeComplete() const
+{
+  return mHasStylesLoaded && matchTreeLayerCount(mpStyleTree.get()) == mLayers.size() + 1;
+}
+
+PathTrie& StyleEngine::pathTrie()
+{
+  return *mpPathTrie;
+}
+
+const StyleEngine::TypeElement& StyleEngine::typeElement(const QMetaObject* pMeta)
+{
+  const char* pClassName = pMeta->className();
+
+  auto iType = mTypeElements.find(pMeta);
+  if (iType != mTypeElements.end()) {
+    if (iType->second.mpClassName == pClassName) {
+      return iType->second;
+    }
+    mTypeElements.erase(iType);
+  }
+
+  if (mTypeElements.size() >= kMaxTypeElementCount) {
+    mTypeElements.clear();
+  }
+
+  auto element = PathElement(normalizeTypename(pClassName));
+  const auto hash = hash_value(element);
+
+  return mTypeElements.emplace(pMeta, TypeElement{pClassName, std::move(element), hash})
+    .first->second;
+}
+
+void StyleEngine::resolveFontFaceDecl(const StyleSheet& styleSheet, const QUrl& baseUrl)
+{
+  AQT_STYLESHEETS_TRACE_SCOPE("resolveFontFaceDecl");
+
   for (auto ffd : styleSheet.fontfaces) {
-    QUrl fontFaceUrl = resolveResourceUrl(
-      mStyleSheetSourceUrl.url(), QUrl(QString::fromStdString(ffd.url)));
+    QUrl fontFaceUrl =
+      resolveResourceUrl(baseUrl, QUrl(QString::fromStdString(ffd.url)));
     QString fontFaceFile = QQmlFile::urlToLocalFileOrQrc(fontFaceUrl);
 
     if (!fontFaceFile.isEmpty()) {
@@ -170,78 +631,509 @@ void StyleEngine::resolveFontFaceDecl(const StyleSheet& styleSheet)
   }
 }
 
-StyleSheet StyleEngine::loadStyleSheet(const QUrl& srcurl)
+bool StyleEngine::loadStyleSheet(const QUrl& srcurl, ParsedStyleSheet& parsed)
 {
-  if (srcurl.isLocalFile() || srcurl.isRelative()) {
+  AQT_STYLESHEETS_TRACE_SCOPE("loadStyleSheet");
+
+  // a source which failed to load the last time is only reported again once
+  // it has changed
+  const auto hasFailedBefore = [&parsed](const QString& path) {
+    return !path.isEmpty() && parsed.mPath == path && parsed.mContentHash.isEmpty()
+           && !parsed.mpStyleSheet;
+  };
+
+  auto result = ParsedStyleSheet{};
+
+  if (!srcurl.isEmpty() && (srcurl.isLocalFile() || srcurl.isRelative())) {
     QString styleFilePath = mBaseUrl.resolved(srcurl).toLocalFile();
+    QFile styleFile(styleFilePath);
+
+    result.mPath = styleFilePath;
+
+    if (styleFilePath.isEmpty() || !styleFile.exists()) {
+      if (hasFailedBefore(styleFilePath)) {
+        return false;
+      }
 
-    if (styleFilePath.isEmpty() || !QFile::exists(styleFilePath)) {
       styleSheetsLogError() << "Style '" << styleFilePath.toStdString() << "' not found";
 
       Q_EMIT exception(QString::fromLatin1("styleSheetNotFound"),
                        QString::fromLatin1("Style '%1' not found.").arg(styleFilePath));
+    } else if (!styleFile.open(QIODevice::ReadOnly)) {
+      if (hasFailedBefore(styleFilePath)) {
+        return false;
+      }
+
+      styleSheetsLogError() << "loading style sheet failed: "
+                            << styleFile.errorString().toStdString();
+
+      Q_EMIT exception(QString::fromLatin1("loadingStyleSheetFailed"),
+                       QString::fromLatin1("Loading style sheet failed '%1'.")
+                         .arg(styleFile.errorString()));
     } else {
-      styleSheetsLogInfo() << "Load style from '" << styleFilePath.toStdString()
-                           << "' ...";
+      const auto content = styleFile.readAll();
+      const auto contentHash =
+        QCryptographicHash::hash(content, QCryptographicHash::Sha1);
+
+      if (parsed.mPath == styleFilePath && parsed.mContentHash == contentHash) {
+        styleSheetsLogDebug() << "Style '" << styleFilePath.toStdString()
+                              << "' is unchanged";
+        return false;
+      }
+
+      result.mContentHash = contentHash;
 
-      try {
-        StyleSheet styleSheet = parseStyleFile(styleFilePath);
+      if (const auto* pPreloaded = preloadedStyleSheet(styleFilePath, contentHash)) {
+        styleSheetsLogInfo() << "Load preloaded style from '"
+                             << styleFilePath.toStdString() << "'";
 
-        resolveFontFaceDecl(styleSheet);
+        result.mpStyleSheet = pPreloaded->mCompiled.mpStyleSheet;
+        resolveFontFaceDecl(*result.mpStyleSheet, srcurl);
+      } else {
+        styleSheetsLogInfo() << "Load style from '" << styleFilePath.toStdString()
+                             << "' ...";
+
+        try {
+          result.mpStyleSheet =
+            std::make_shared<const StyleSheet>(parseStdString(content.toStdString()));
 
-        return styleSheet;
-      } catch (const ParseException& e) {
-        styleSheetsLogError() << e.message() << ": " << e.errorContext();
+          resolveFontFaceDecl(*result.mpStyleSheet, srcurl);
+        } catch (const ParseException& e) {
+          styleSheetsLogError() << e.message() << ": " << e.errorContext();
 
-        Q_EMIT exception(QString::fromLatin1("parsingStyleSheetfailed"),
-                         QString::fromLatin1("Parsing style sheet failed '%1'.")
-                           .arg(QString::fromStdString(e.message())));
-      } catch (const std::ios_base::failure& fail) {
-        styleSheetsLogError() << "loading style sheet failed: " << fail.what();
+          Q_EMIT exception(QString::fromLatin1("parsingStyleSheetfailed"),
+                           QString::fromLatin1("Parsing style sheet failed '%1'.")
+                             .arg(QString::fromStdString(e.message())));
 
-        Q_EMIT exception(QString::fromLatin1("loadingStyleSheetFailed"),
-                         QString::fromLatin1("Loading style sheet failed '%1'.")
-                           .arg(QString::fromStdString(fail.what())));
+          // keep the content hash: the same broken content is not parsed again
+          result.mpStyleSheet.reset();
+        }
       }
     }
+  } else if (parsed.mPath.isEmpty() && parsed.mContentHash.isEmpty()
+             && !parsed.mpStyleSheet) {
+    return false;
   }
 
-  return StyleSheet();
+  parsed = std::move(result);
+  return true;
 }
 
-void StyleEngine::loadStyles()
+std::vector<StyleEngine::ParsedStyleSheet> StyleEngine::parsedStyleSheets() const
 {
-  StyleSheet styleSheet;
-  StyleSheet defaultStyleSheet;
-
-  if (!mStyleSheetSourceUrl.isEmpty()) {
-    styleSheet = loadStyleSheet(mStyleSheetSourceUrl.url());
+  std::vector<ParsedStyleSheet> result;
+  for (const auto& layer : mLayers) {
+    result.push_back(layer.mStyleSheet);
   }
 
-  if (!mDefaultStyleSheetSourceUrl.isEmpty()) {
-    defaultStyleSheet = loadStyleSheet(mDefaultStyleSheetSourceUrl.url());
+  return result;
+}
+
+std::vector<std::size_t> StyleEngine::loadChangedStyleSheets()
+{
+  std::vector<std::size_t> changedLayers;
+
+  for (std::size_t i = 0; i < mLayers.size(); ++i) {
+    if (loadStyleSheet(mLayers[i].mSourceUrl, mLayers[i].mStyleSheet)) {
+      changedLayers.push_back(i);
+    }
   }
 
-  mpStyleTree = createMatchTree(styleSheet, defaultStyleSheet);
+  return changedLayers;
+}
+
+void StyleEngine::applyStyleSheets(
+  const std::vector<std::size_t>& changedLayers,
+  const std::vector<ParsedStyleSheet>& previousStyleSheets)
+{
+  const auto userLayer = mLayers.size() - 1;
+  const auto layersGeneration = mLayersGeneration;
+  const auto& previousUserStyleSheetPath = previousStyleSheets.back().mPath;
+
+  // the cached properties are only valid for the styles they were resolved from
+  mpStyleCache.reset();
+
+  if (isStyleTreeComplete()) {
+    const auto* pPreloaded = changedLayers == std::vector<std::size_t>{userLayer}
+                               ? preloadedStyleTree(mLayers[userLayer].mStyleSheet)
+                               : nullptr;
+
+    if (pPreloaded) {
+      switchToPreloadedStyleSheet(*pPreloaded, previousUserStyleSheetPath);
+    } else {
+      const auto emptyStyleSheet = StyleSheet();
+      std::vector<StyleSheet> changedRules;
+      std::vector<StyleSheet> movedRules;
+
+      for (const auto layer : changedLayers) {
+        const auto* pOldStyleSheet = previousStyleSheets[layer].mpStyleSheet.get();
+        const auto& oldStyleSheet = pOldStyleSheet ? *pOldStyleSheet : emptyStyleSheet;
+        const auto* pStyleSheet = mLayers[layer].mStyleSheet.mpStyleSheet.get();
+        const auto& styleSheet = pStyleSheet ? *pStyleSheet : emptyStyleSheet;
+
+        // the layer is built again even if no rule changed, since the source
+        // locations of its rules might have moved
+        mpStyleTree = replaceMatchTreeLayer(mpStyleTree.get(), layer, styleSheet);
+
+        auto rules = changedPropsets(oldStyleSheet, styleSheet);
+        auto moved = movedPropsets(oldStyleSheet, styleSheet);
+        if ((!rules.propsets.empty() || !moved.propsets.empty()) && layer != userLayer) {
+          mLayersGeneration = layersGeneration + 1;
+        }
+
+        if (!rules.propsets.empty()) {
+          changedRules.emplace_back(std::move(rules));
+        }
+        if (!moved.propsets.empty()) {
+          movedRules.emplace_back(std::move(moved));
+        }
+      }
+
+      reloadTouchedProperties(changedRules, movedRules);
+    }
+  } else {
+    std::vector<const StyleSheet*> styleSheets;
+    for (const auto& layer : mLayers) {
+      styleSheets.push_back(layer.mStyleSheet.mpStyleSheet.get());
+    }
+    styleSheets.push_back(mpOverrides.get());
 
-  reloadAllProperties();
+    mpStyleTree = createMatchTree(styleSheets);
+    mLayersGeneration = layersGeneration + 1;
+
+    openStyleCache();
+    reloadAllProperties();
+  }
 
   mHasStylesLoaded = true;
+
+  if (mLayersGeneration != layersGeneration) {
+    recompilePreloadedStyleSheets();
+  }
+
   notifyMissingProperties();
 
   Q_EMIT styleChanged();
 }
 
+void StyleEngine::loadStyles()
+{
+  if (mUpdateDepth > 0) {
+    mIsLoadPending = true;
+    return;
+  }
+
+  const auto startTime = std::chrono::steady_clock::now();
+  const auto previousStyleSheets = parsedStyleSheets();
+  applyStyleSheets(loadChangedStyleSheets(), previousStyleSheets);
+  countReload(startTime);
+}
+
+bool StyleEngine::reloadChangedStyles()
+{
+  if (mUpdateDepth > 0) {
+    mIsLoadPending = true;
+    return false;
+  }
+
+  const auto startTime = std::chrono::steady_clock::now();
+  const auto previousStyleSheets = parsedStyleSheets();
+  const auto changedLayers = loadChangedStyleSheets();
+  if (changedLayers.empty()) {
+    return false;
+  }
+
+  applyStyleSheets(changedLayers, previousStyleSheets);
+  countReload(startTime);
+  return true;
+}
+
+void StyleEngine::preloadStyleSheet(const QUrl& url, bool inBackground)
+{
+  if (url.isEmpty() || !(url.isLocalFile() || url.isRelative())) {
+    return;
+  }
+
+  const auto path = mBaseUrl.resolved(url).toLocalFile();
+  if (path.isEmpty()) {
+    return;
+  }
+
+  auto& preloaded = mPreloadedStyleSheets[path];
+  preloaded.mSourceUrl = url;
+  preloaded.mInBackground = inBackground;
+
+  compileStyleSheet(path, preloaded);
+}
+
+void StyleEngine::clearPreloadedStyleSheets()
+{
+  mPreloadedStyleSheets.clear();
+}
+
+void StyleEngine::compileStyleSheet(const QString& path, PreloadedStyleSheet& preloaded)
+{
+  preloaded.mCompiled = CompiledStyleSheet{};
+  preloaded.mLayersGeneration = mLayersGeneration;
+  preloaded.mpOverrides = mpOverrides;
+
+  QFile styleFile(path);
+  if (!styleFile.open(QIODevice::ReadOnly)) {
+    styleSheetsLogWarning() << "Could not preload style '" << path.toStdString()
+                            << "': " << styleFile.errorString().toStdString();
+    preloaded.mContentHash = QByteArray();
+    preloaded.mPendingCompilation = std::future<CompiledStyleSheet>();
+    return;
+  }
+
+  const auto content = styleFile.readAll();
+  preloaded.mContentHash = QCryptographicHash::hash(content, QCryptographicHash::Sha1);
+
+  // without the other layers loaded yet only the style sheet is parsed
+  const auto pBaseStyleTree =
+    isStyleTreeComplete() ? mpStyleTree : std::shared_ptr<const IStyleMatchTree>();
+  const auto userLayer = mLayers.size() - 1;
+
+  std::vector<const PathNode*> paths;
+  paths.reserve(mPropertyMaps.size());
+  for (const auto& element : mPropertyMaps) {
+    paths.push_back(element.first);
+  }
+
+  preloaded.mPendingCompilation =
+    std::async(preloaded.mInBackground ? std::launch::async : std::launch::deferred,
+               [content, pBaseStyleTree, userLayer, paths]() {
+                 AQT_STYLESHEETS_TRACE_SCOPE("compileStyleSheet");
+
+                 auto result = CompiledStyleSheet{};
+                 result.mpStyleSheet = std::make_shared<const StyleSheet>(
+                   parseStdString(content.toStdString()));
+
+                 if (pBaseStyleTree) {
+                   result.mpStyleTree = replaceMatchTreeLayer(
+                     pBaseStyleTree.get(), userLayer, *result.mpStyleSheet);
+
+                   for (const auto* pPath : paths) {
+                     matchPropertyMap(
+                       result.mpStyleTree.get(), pPath, result.mPropertyMaps);
+                   }
+                 }
+
+                 return result;
+               });
+
+  if (!preloaded.mInBackground) {
+    finishCompilation(preloaded);
+  }
+}
+
+void StyleEngine::finishCompilation(PreloadedStyleSheet& preloaded)
+{
+  if (preloaded.mPendingCompilation.valid()) {
+    try {
+      preloaded.mCompiled = preloaded.mPendingCompilation.get();
+    } catch (const ParseException& e) {
+      styleSheetsLogError() << "Preloading style sheet failed: " << e.message() << ": "
+                            << e.errorContext();
+      preloaded.mCompiled = CompiledStyleSheet{};
+    }
+  }
+}
+
+void StyleEngine::recompilePreloadedStyleSheets()
+{
+  for (auto& element : mPreloadedStyleSheets) {
+    compileStyleSheet(element.first, element.second);
+  }
+}
+
+StyleEngine::PreloadedStyleSheet* StyleEngine::preloadedStyleSheet(
+  const QString& path, const QByteArray& contentHash)
+{
+  const auto iPreloaded = mPreloadedStyleSheets.find(path);
+  if (iPreloaded == mPreloadedStyleSheets.end()
+      || iPreloaded->second.mContentHash != contentHash) {
+    return nullptr;
+  }
+
+  finishCompilation(iPreloaded->second);
+  return iPreloaded->second.mCompiled.mpStyleSheet ? &iPreloaded->second : nullptr;
+}
+
+StyleEngine::PreloadedStyleSheet* StyleEngine::preloadedStyleTree(
+  const ParsedStyleSheet& parsed)
+{
+  const auto iPreloaded = mPreloadedStyleSheets.find(parsed.mPath);
+  if (iPreloaded == mPreloadedStyleSheets.end()) {
+    return nullptr;
+  }
+
+  auto& preloaded = iPreloaded->second;
+  finishCompilation(preloaded);
+
+  const auto isUpToDate = preloaded.mCompiled.mpStyleSheet == parsed.mpStyleSheet
+                          && preloaded.mCompiled.mpStyleTree
+                          && preloaded.mLayersGeneration == mLayersGeneration;
+  if (!isUpToDate) {
+    return nullptr;
+  }
+
+  if (preloaded.mpOverrides != mpOverrides) {
+    updatePreloadedOverrides(preloaded);
+  }
+
+  return &preloaded;
+}
+
+void StyleEngine::updatePreloadedOverrides(PreloadedStyleSheet& preloaded)
+{
+  const auto emptyStyleSheet = StyleSheet();
+  const auto& oldOverrides =
+    preloaded.mpOverrides ? *preloaded.mpOverrides : emptyStyleSheet;
+  const auto& overrides = mpOverrides ? *mpOverrides : emptyStyleSheet;
+
+  // only the overrides layer differs from the current styles; the other
+  // layers are the ones the style sheet has been compiled against
+  auto& compiled = preloaded.mCompiled;
+  compiled.mpStyleTree =
+    replaceMatchTreeLayer(compiled.mpStyleTree.get(), mLayers.size(), overrides);
+
+  // moved overrides are dropped, too: the maps point to their old locations
+  const auto touchedRules = std::vector<StyleSheet>{
+    changedPropsets(oldOverrides, overrides), movedPropsets(oldOverrides, overrides)};
+  takeAffectedPropertyMaps(compiled.mPropertyMaps,
+                           AffectedPaths{matchedByAnyOf(touchedRules)});
+
+  preloaded.mpOverrides = mpOverrides;
+}
+
+void StyleEngine::switchToPreloadedStyleSheet(const PreloadedStyleSheet& preloaded,
+                                              const QString& previousUserStyleSheetPath)
+{
+  ++mPreloadedSwitchCount;
+
+  collectUnusedStyleSetProps();
+
+  // keep the old maps alive until all StyleSetProps have dropped them, and
+  // warm for switching back if the replaced style sheet has been preloaded
+  auto oldPropertyMaps = PropertyMaps{};
+  oldPropertyMaps.swap(mPropertyMaps);
+
+  for (auto& element : mPreloadedStyleSheets) {
+    if (element.second.mCompiled.mpStyleTree == mpStyleTree) {
+      element.second.mCompiled.mPropertyMaps = oldPropertyMaps;
+    }
+  }
+
+  mpStyleTree = preloaded.mCompiled.mpStyleTree;
+  mPropertyMaps = preloaded.mCompiled.mPropertyMaps;
+  mpSnapshot.reset();
+
+  // url() values are resolved relative to the style sheet defining them
+  const auto hasSameBaseDir =
+    QFileInfo(previousUserStyleSheetPath).absolutePath()
+    == QFileInfo(mLayers.back().mStyleSheet.mPath).absolutePath();
+
+  // iterate over a copy: reloading notifies QML, which might create new
+  // StyleSets and with them new StyleSetProps
+  const auto styleSetPropsInstances = mStyleSetPropsInstances;
+  for (auto& pInstance : styleSetPropsInstances) {
+    auto& styleSetProps = pInstance->styleSetProps;
+
+    // instances nobody has read from are only marked stale; resolving them
+    // here just for the comparison would undo the lazy resolution
+    if (!styleSetProps.hasBeenRead()) {
+      styleSetProps.loadProperties();
+      continue;
+    }
+
+    const auto iOldProps = oldPropertyMaps.find(styleSetProps.path());
+
+    if (hasSameBaseDir && iOldProps != oldPropertyMaps.end()
+        && haveSameValues(
+             *iOldProps->second, *effectivePropertyMap(styleSetProps.path()))) {
+      styleSetProps.rebindProperties();
+    } else {
+      styleSetProps.loadProperties();
+    }
+  }
+}
+
+void StyleEngine::beginUpdate()
+{
+  ++mUpdateDepth;
+}
+
+void StyleEngine::endUpdate()
+{
+  assert(mUpdateDepth > 0);
+
+  if (--mUpdateDepth == 0 && mIsLoadPending) {
+    mIsLoadPending = false;
+    loadStyles();
+  }
+}
+
 void StyleEngine::reloadAllProperties()
 {
-  mPropertyMaps.clear();
+  AQT_STYLESHEETS_TRACE_SCOPE("reloadAllProperties");
 
-  auto oldPropertyMapInstances = PropertyMapInstances{};
-  oldPropertyMapInstances.swap(mPropertyMapInstances);
+  collectUnusedStyleSetProps();
 
-  for (auto& element : mStyleSetPropsRefs) {
-    auto pStyleSetProps = element.second.get();
-    pStyleSetProps->loadProperties();
+  // keep the old maps alive until all StyleSetProps have dropped them
+  auto oldPropertyMaps = PropertyMaps{};
+  oldPropertyMaps.swap(mPropertyMaps);
+  mpSnapshot.reset();
+
+  // iterate over a copy: reloading notifies QML, which might create new
+  // StyleSets and with them new StyleSetProps
+  const auto styleSetPropsInstances = mStyleSetPropsInstances;
+  for (auto& pInstance : styleSetPropsInstances) {
+    pInstance->styleSetProps.loadProperties();
+  }
+}
+
+void StyleEngine::reloadTouchedProperties(const std::vector<StyleSheet>& changedRules,
+                                          const std::vector<StyleSheet>& movedRules)
+{
+  if (changedRules.empty() && movedRules.empty()) {
+    return;
+  }
+
+  // Only paths matched by a changed rule, before or after the change, can
+  // be styled differently now.  Paths matched by a moved rule are styled the
+  // same, but their properties still point to the old source locations.
+  reloadTouchedProperties(matchedByAnyOf(changedRules), matchedByAnyOf(movedRules));
+}
+
+void StyleEngine::reloadTouchedProperties(
+  const std::function<bool(const UiItemPath&)>& isTouched,
+  const std::function<bool(const UiItemPath&)>& isMoved)
+{
+  AQT_STYLESHEETS_TRACE_SCOPE("reloadTouchedProperties");
+
+  collectUnusedStyleSetProps();
+
+  auto isAffected = AffectedPaths{isTouched};
+  auto isRelocated = AffectedPaths{isMoved};
+
+  // keep the dropped maps alive until all StyleSetProps have dropped them
+  const auto oldPropertyMaps =
+    takeAffectedPropertyMaps(mPropertyMaps, [&](const PathNode* pPath) {
+      return isAffected(pPath) || isRelocated(pPath);
+    });
+  mpSnapshot.reset();
+
+  // iterate over a copy: reloading notifies QML, which might create new
+  // StyleSets and with them new StyleSetProps
+  const auto styleSetPropsInstances = mStyleSetPropsInstances;
+  for (auto& pInstance : styleSetPropsInstances) {
+    auto& styleSetProps = pInstance->styleSetProps;
+    if (isAffected(styleSetProps.path())) {
+      styleSetProps.loadProperties();
+    } else if (isRelocated(styleSetProps.path())) {
+      styleSetProps.rebindProperties();
+    }
   }
 }
 
@@ -250,59 +1142,103 @@ QUrl StyleEngine::resolveResourceUrl(const QUrl& baseUrl, const QUrl& url) const
   return searchForResourceSearchPath(baseUrl, url, mImportPaths);
 }
 
-StyleSetPropsRef StyleEngine::styleSetProps(const UiItemPath& path)
+StyleSetPropsRef StyleEngine::styleSetProps(const PathNode* pPath)
 {
-  auto iElement = mStyleSetPropsRefs.find(path);
+  auto iElement = mStyleSetPropsRefs.find(pPath);
 
   if (iElement == mStyleSetPropsRefs.end()) {
+    if (mStyleSetPropsInstances.size() >= mStyleSetPropsCollectionSize) {
+      collectUnusedStyleSetProps();
+    }
+
     mStyleSetPropsInstances.emplace_back(
-      std::make_shared<UsageCountedStyleSetProps>(path));
+      std::make_shared<UsageCountedStyleSetProps>(pPath));
 
     auto pStyleSetProps = mStyleSetPropsInstances.back();
     std::tie(iElement, std::ignore) =
-      mStyleSetPropsRefs.emplace(path, StyleSetPropsRef{pStyleSetProps});
+      mStyleSetPropsRefs.emplace(pPath, StyleSetPropsRef{pStyleSetProps});
   }
 
   return iElement->second;
 }
 
-PropertyMap* StyleEngine::properties(const UiItemPath& path)
+void StyleEngine::collectUnusedStyleSetProps()
 {
-  return effectivePropertyMap(path);
-}
+  for (auto iElement = mStyleSetPropsRefs.begin();
+       iElement != mStyleSetPropsRefs.end();) {
+    // the reference held by the engine itself is the last one left
+    if (iElement->second.usageCount() <= 1) {
+      iElement = mStyleSetPropsRefs.erase(iElement);
+    } else {
+      ++iElement;
+    }
+  }
 
-PropertyMap* StyleEngine::effectivePropertyMap(const UiItemPath& path)
-{
-  using std::begin;
-  using std::end;
-  using std::prev;
+  mStyleSetPropsInstances.erase(
+    std::remove_if(mStyleSetPropsInstances.begin(), mStyleSetPropsInstances.end(),
+                   [](const std::shared_ptr<UsageCountedStyleSetProps>& pInstance) {
+                     return pInstance->usageCount == 0;
+                   }),
+    mStyleSetPropsInstances.end());
+
+  // keep the property maps of the remaining paths only.  Cached maps of
+  // ancestor paths are dropped as well; they are rebuilt when needed again.
+  PropertyMaps usedPropertyMaps;
+
+  for (const auto& element : mStyleSetPropsRefs) {
+    const auto iPropertyMap = mPropertyMaps.find(element.first);
+    if (iPropertyMap != mPropertyMaps.end()) {
+      usedPropertyMaps.insert(*iPropertyMap);
+    }
+  }
 
-  const auto iElement = mPropertyMaps.find(path);
-  if (iElement != mPropertyMaps.end()) {
-    return iElement->second;
+  if (usedPropertyMaps.size() != mPropertyMaps.size()) {
+    // the snapshot keeps the dropped maps; they are still valid for the styles
+    mPropertyMaps.swap(usedPropertyMaps);
   }
 
-  auto props = matchPath(mpStyleTree.get(), path);
+  mStyleSetPropsCollectionSize =
+    std::max(kMinStyleSetPropsCollectionSize, 2 * mStyleSetPropsInstances.size());
+}
 
-  if (path.size() > 1) {
-    auto* pAncestorProps = effectivePropertyMap({begin(path), prev(end(path))});
+PropertyMap* StyleEngine::properties(const PathNode* pPath)
+{
+  return effectivePropertyMap(pPath).get();
+}
 
-    if (props.empty()) {
-      // point to our ancestor props and return them immediately
-      // without storing our own props instance
-      mPropertyMaps.emplace(path, pAncestorProps);
-      return pAncestorProps;
-    } else {
-      props.insert(begin(*pAncestorProps), end(*pAncestorProps));
-    }
+std::shared_ptr<const StyleSnapshot> StyleEngine::snapshot()
+{
+  // Paths resolved after the snapshot has been taken are resolved by the
+  // snapshot itself when asked for.  Taking it again once the engine has
+  // resolved twice as many paths keeps the copying amortized constant per
+  // resolved path.
+  const auto isOutgrown =
+    mPropertyMaps.size()
+    >= 2 * std::max(mSnapshotPropertyMapCount, kMinSnapshotPropertyMapCount);
+
+  if (!mpSnapshot || isOutgrown) {
+    mpSnapshot = std::make_shared<const StyleSnapshot>(
+      mpStyleTree, mpPathTrie,
+      StyleSnapshot::PropertyMaps(mPropertyMaps.begin(), mPropertyMaps.end()));
+    mSnapshotPropertyMapCount = mPropertyMaps.size();
   }
 
-  mPropertyMapInstances.emplace_back(estd::make_unique<PropertyMap>(std::move(props)));
+  return mpSnapshot;
+}
 
-  auto* pProps = mPropertyMapInstances.back().get();
-  mPropertyMaps.emplace(path, pProps);
+std::shared_ptr<PropertyMap> StyleEngine::effectivePropertyMap(const PathNode* pPath)
+{
+  AQT_STYLESHEETS_TRACE_SCOPE("effectivePropertyMap");
 
-  return pProps;
+  if (mPropertyMaps.find(pPath) == mPropertyMaps.end()) {
+    // the snapshot taken last stays valid: the styles did not change
+    ++mPropertyMapMisses;
+  } else {
+    ++mPropertyMapHits;
+  }
+
+  return matchPropertyMap(mpStyleTree.get(), pPath, mPropertyMaps, mpStyleCache.get(),
+                          mpMatchProfile.get());
 }
 
 void StyleEngine::setMissingPropertiesFound()
@@ -321,9 +1257,14 @@ void StyleEngine::notifyMissingProperties()
 
 void StyleEngine::checkProperties()
 {
-  for (auto& element : mStyleSetPropsRefs) {
-    if (element.second.usageCount() > 1) {
-      element.second.get()->checkProperties();
+  AQT_STYLESHEETS_TRACE_SCOPE("checkProperties");
+
+  // iterate over a copy: the exception() signals emitted while checking end
+  // up in QML, which might create new StyleSets and with them new StyleSetProps
+  const auto styleSetPropsInstances = mStyleSetPropsInstances;
+  for (auto& pInstance : styleSetPropsInstances) {
+    if (pInstance->usageCount > 1) {
+      pInstance->styleSetProps.checkProperties();
     }
   }
 
@@ -331,5 +1272,83 @@ void StyleEngine::checkProperties()
   mMissingPropertiesNotified = false;
 }
 
+void StyleEngine::setDiagnostics(Diagnostics diagnostics)
+{
+  mDiagnostics = diagnostics;
+}
+
+StyleEngine::Diagnostics StyleEngine::diagnostics() const
+{
+  return mDiagnostics;
+}
+
+void StyleEngine::countMissingProperty(const QString& key)
+{
+  auto& pCounter = mMissingPropertyCounters[key];
+  if (!pCounter) {
+    mMissingPropertyCounterSlots.emplace_back(0);
+    pCounter = &mMissingPropertyCounterSlots.back();
+  }
+
+  pCounter->fetch_add(1, std::memory_order_relaxed);
+}
+
+std::size_t StyleEngine::missingPropertyCount(const QString& key) const
+{
+  const auto* pCounter = mMissingPropertyCounters.value(key, nullptr);
+  return pCounter ? pCounter->load(std::memory_order_relaxed) : 0;
+}
+
+bool StyleEngine::countConversionFailure()
+{
+  const auto count = mConversionFailureCount.fetch_add(1, std::memory_order_relaxed) + 1;
+
+  // log the 1st, 2nd, 4th, 8th, ... failure only
+  return mDiagnostics == Diagnostics::Full || (count & (count - 1)) == 0;
+}
+
+std::size_t StyleEngine::conversionFailureCount() const
+{
+  return mConversionFailureCount.load(std::memory_order_relaxed);
+}
+
+void StyleEngine::countReload(std::chrono::steady_clock::time_point startTime)
+{
+  mLastReloadDuration = std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - startTime);
+  mTotalReloadDuration += mLastReloadDuration;
+  ++mReloadCount;
+}
+
+StyleEngine::Stats StyleEngine::stats() const
+{
+  auto result = Stats{};
+
+  result.styleSetPropsCount = mStyleSetPropsInstances.size();
+  result.cachedPathCount = mPropertyMaps.size();
+
+  std::unordered_set<const PropertyMap*> uniquePropertyMaps;
+  for (const auto& element : mPropertyMaps) {
+    uniquePropertyMaps.insert(element.second.get());
+  }
+  result.uniquePropertyMapCount = uniquePropertyMaps.size();
+
+  const auto treeSize = matchTreeSize(mpStyleTree.get());
+  result.matchTreeNodeCount = treeSize.nodeCount;
+  result.matchTreeByteCount = treeSize.byteCount;
+
+  result.propertyMapHits = mPropertyMapHits;
+  result.propertyMapMisses = mPropertyMapMisses;
+  result.conversionCount = conversionCount();
+  result.conversionFailureCount = conversionFailureCount();
+
+  result.reloadCount = mReloadCount;
+  result.preloadedSwitchCount = mPreloadedSwitchCount;
+  result.lastReloadDuration = mLastReloadDuration;
+  result.totalReloadDuration = mTotalReloadDuration;
+
+  return result;
+}
+
 } // namespace stylesheets
 } // namespace aqt
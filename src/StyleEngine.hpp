@@ -22,16 +22,28 @@ THE SOFTWARE.
 
 #pragma once
 
+#include "PathTrie.hpp"
+#include "StyleCache.hpp"
 #include "StyleMatchTree.hpp"
 #include "StyleSetProps.hpp"
+#include "StyleSnapshot.hpp"
 #include "Warnings.hpp"
 
 SUPPRESS_WARNINGS
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QList>
 #include <QtCore/QObject>
 #include <QtCore/QString>
 #include <QtCore/QUrl>
 RESTORE_WARNINGS
 
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -55,6 +67,48 @@ class StyleEngine : public QObject
   Q_DISABLE_COPY(StyleEngine)
 
 public:
+  /*! How much effort goes into reporting property lookup problems */
+  enum class Diagnostics {
+    //! Missing properties are recorded by name for StyleChecker, each failed
+    //! conversion is logged together with its path
+    Full,
+    //! Missing properties are only counted, failed conversions are counted
+    //! and logged with exponential back-off
+    Counting
+  };
+
+  /*! Counters describing the state of the engine and the work it has done
+   *
+   * Counters of work done accumulate over the lifetime of the engine.
+   */
+  struct Stats
+  {
+    //! StyleSetProps instances, unused ones not collected yet included
+    std::size_t styleSetPropsCount = 0;
+    //! paths with a resolved property map
+    std::size_t cachedPathCount = 0;
+    //! property maps shared by the cached paths; paths without properties
+    //! of their own share the map of their parent
+    std::size_t uniquePropertyMapCount = 0;
+    //! match nodes of the loaded styles, all layers included
+    std::size_t matchTreeNodeCount = 0;
+    //! an estimate of the memory taken by the match nodes
+    std::size_t matchTreeByteCount = 0;
+    //! lookups of paths with an already resolved property map
+    std::size_t propertyMapHits = 0;
+    //! lookups of paths which had to be resolved
+    std::size_t propertyMapMisses = 0;
+    //! property values converted, process wide
+    std::size_t conversionCount = 0;
+    std::size_t conversionFailureCount = 0;
+    //! loads and reloads of the style sheets, parsing included
+    std::size_t reloadCount = 0;
+    //! reloads which switched to the match tree of a preloaded style sheet
+    std::size_t preloadedSwitchCount = 0;
+    std::chrono::microseconds lastReloadDuration{0};
+    std::chrono::microseconds totalReloadDuration{0};
+  };
+
   /*! @cond DOXYGEN_IGNORE */
   static StyleEngine& instance();
 
@@ -66,7 +120,71 @@ class StyleEngine : public QObject
   QUrl defaultStyleSheetSource() const;
   void setDefaultStyleSheetSource(const QUrl& url);
 
-  std::string describeMatchedPath(const UiItemPath& path) const;
+  /*! Returns the sources of the layers between default and user style sheet
+   *
+   * The layers are ordered by ascending precedence.
+   */
+  QList<QUrl> styleSheetLayerSources() const;
+  void setStyleSheetLayerSources(const QList<QUrl>& urls);
+
+  /*! Returns the number of style sheet layers
+   *
+   * Includes the default style sheet (layer 0) and the user style sheet (the
+   * topmost layer).
+   */
+  std::size_t styleSheetLayerCount() const;
+
+  /*! Returns the source url of the style sheet layer @p layer */
+  QUrl styleSheetLayerSource(std::size_t layer) const;
+
+  std::string describeMatchedPath(const PathNode* pPath) const;
+
+  /*! Starts or stops profiling the matching of paths
+   *
+   * While profiling, the engine counts per rule of the loaded style sheets
+   * how often it has been tested, how much work has been spent on trying to
+   * match it, how often it matched and for how many paths it contributed a
+   * property.  The time spent on matching is recorded per path.  Starting
+   * discards the results of an earlier profiling run.  Properties compiled
+   * for preloaded style sheets are not profiled.
+   */
+  void setProfiling(bool isProfiling);
+  bool profiling() const;
+
+  /*! Returns the results of the current profiling run as JSON
+   *
+   * Lists all rules of the loaded styles, those never matched included.
+   * Rules with the same selector are counted together and listed once,
+   * under the source location of their first declaration.  Returns an empty
+   * string if not profiling.
+   *
+   * @see matchProfileToJson()
+   */
+  std::string matchProfile() const;
+
+  /*! Returns the trie interning all paths known to this engine
+   *
+   * Path nodes stay valid as long as this StyleEngine instance exists.
+   */
+  PathTrie& pathTrie();
+
+  //! A type's normalized name as a path element without class names
+  struct TypeElement {
+    //! the class name the entry was built from; a dynamic QML meta object
+    //! deleted and allocated again at the same address comes with a new one
+    const char* mpClassName;
+    PathElement mElement;
+    std::size_t mHash;
+  };
+
+  /*! Returns the path element for objects of the type described by @p pMeta
+   *
+   * The elements are cached for the lifetime of this engine.  Types defined
+   * in QML can come with a new meta object per component instance, so the
+   * cache is dropped whenever it grows beyond a fixed number of entries.  The
+   * result stays valid until the next call.
+   */
+  const TypeElement& typeElement(const QMetaObject* pMeta);
 
   /*! @endcond */
 
@@ -77,36 +195,83 @@ class StyleEngine : public QObject
    */
   QUrl resolveResourceUrl(const QUrl& baseUrl, const QUrl& url) const;
 
-  /*! Returns a StyleSetPropsRef to StyleSetProps corresponding to @p path
+  /*! Returns a StyleSetPropsRef to StyleSetProps corresponding to @p pPath
    *
-   * Subsequent calls with identical @p path will return StyleSetPropsRefs with pointers
+   * Subsequent calls with identical @p pPath will return StyleSetPropsRefs with pointers
    * to the same StyleSetProps instance.
    *
    * StyleSetPropsRef.get() will never return nullptr, but pointers will be invalidated if
-   * and only if this StyleEngine instance is destroyed.
+   * this StyleEngine instance is destroyed or when the StyleSetProps instance is
+   * collected after the last StyleSetPropsRef to it has been released.
    */
-  StyleSetPropsRef styleSetProps(const UiItemPath& path);
+  StyleSetPropsRef styleSetProps(const PathNode* pPath);
 
-  /*! Returns a pointer to the PropertyMap corresponding to @p path
+  /*! Releases all StyleSetProps instances which are not used anymore
    *
-   * The element path @p path is matched against the rules loaded from the
+   * Drops all StyleSetProps no StyleSetPropsRef (apart from the engine's own)
+   * refers to, together with the cached property maps only they were using.
+   * This is done automatically in batches when the number of StyleSetProps
+   * instances has doubled since the last collection and before reloading the
+   * styles.
+   */
+  void collectUnusedStyleSetProps();
+
+  /*! Returns a pointer to the PropertyMap corresponding to @p pPath
+   *
+   * The element path @p pPath is matched against the rules loaded from the
    * current style sheet.  The resulting set of properties is returned.  If
    * the path is not matching any rule the result is an empty property map.
    *
-   * Subsequent calls with identical @p path will return pointers to the same
+   * Subsequent calls with identical @p pPath will return pointers to the same
    * PropertyMap instance.
    *
    * Will never return nullptr, but pointers will be invalidated if and only
    * if the style changes or this StyleEngine instance is destroyed.
    */
-  PropertyMap* properties(const UiItemPath& path);
+  PropertyMap* properties(const PathNode* pPath);
+
+  /*! Returns an immutable snapshot of the currently loaded styles
+   *
+   * The snapshot can be queried from any thread and stays valid across
+   * reloads of the styles.  Must be called from the GUI thread.  The snapshot
+   * is replaced when the styles are reloaded or overridden.  Paths resolved
+   * by the engine later on do not replace it until their number has doubled.
+   */
+  std::shared_ptr<const StyleSnapshot> snapshot();
 
   /*! Loads the styles from the previously set style sheet sources
    *
    * It is safe to call if the sources have not been set yet or have been only partly set.
+   * Between beginUpdate() and endUpdate() the load is deferred until the
+   * outermost endUpdate().
    */
   void loadStyles();
 
+  /*! Starts a batch of configuration changes
+   *
+   * Loading the styles is deferred until the matching call to endUpdate(), so
+   * that any number of source changes results in a single load.  Calls can be
+   * nested.
+   */
+  void beginUpdate();
+
+  /*! Ends a batch of configuration changes started with beginUpdate()
+   *
+   * Loads the styles if this ends the outermost batch and loadStyles() or
+   * reloadChangedStyles() has been called during the batch.
+   */
+  void endUpdate();
+
+  /*! Reloads the styles if the content of any style sheet source changed
+   *
+   * Only the style sheets whose content changed since they were last loaded
+   * are parsed again; the parsed form of the others is reused.  Returns false
+   * without touching the loaded styles if all sources are unchanged.  Sources
+   * which are still missing or broken count as unchanged and are not reported
+   * again.
+   */
+  bool reloadChangedStyles();
+
   bool hasStylesLoaded() const;
   void unloadStyles();
 
@@ -114,6 +279,87 @@ class StyleEngine : public QObject
 
   void checkProperties();
 
+  /*! Selects the diagnostics mode
+   *
+   * Defaults to Diagnostics::Counting in release builds configured with
+   * AQT_STYLESHEETS_COUNTING_DIAGNOSTICS and to Diagnostics::Full otherwise.
+   */
+  void setDiagnostics(Diagnostics diagnostics);
+  Diagnostics diagnostics() const;
+
+  /*! Counts a lookup of the missing property @p key (Diagnostics::Counting)
+   *
+   * Each key is interned once into its own atomic counter; later lookups of
+   * the same key only increment that counter.
+   */
+  void countMissingProperty(const QString& key);
+
+  /*! Returns how often the missing property @p key has been looked up */
+  std::size_t missingPropertyCount(const QString& key) const;
+
+  /*! Counts a failed conversion and returns whether to log it */
+  bool countConversionFailure();
+
+  std::size_t conversionFailureCount() const;
+
+  /*! Returns the current statistics of the engine
+   *
+   * Walks the match tree and all cached property maps; not meant to be
+   * called on every frame.
+   */
+  Stats stats() const;
+
+  /*! Parses and compiles the style sheet at @p url for later use as user style sheet
+   *
+   * Builds the match tree with the style sheet on top of the currently loaded
+   * layers and computes the effective properties of all paths in use.  When
+   * the style sheet becomes the user style sheet later on and its content is
+   * unchanged, loading it swaps in the precompiled match tree and properties
+   * and notifies only the StyleSetProps whose property values differ.  The
+   * properties of the replaced user style sheet are kept for switching back
+   * if it has been preloaded as well.
+   *
+   * With @p inBackground the style sheet is compiled on a background thread.
+   * Preloaded style sheets are compiled again whenever any layer but the user
+   * style sheet changes.
+   */
+  void preloadStyleSheet(const QUrl& url, bool inBackground);
+
+  /*! Drops all style sheets preloaded with preloadStyleSheet() */
+  void clearPreloadedStyleSheets();
+
+  /*! Sets @p property to @p value for all items matching @p selector
+   *
+   * Overrides form a layer on top of the user style sheet; for rules of the
+   * same specificity they win over all style sheets.  Setting an override
+   * again for the same selector and property replaces its value.  Only the
+   * StyleSetProps of paths matched by @p selector are updated.  Preloaded
+   * style sheets are not compiled again; the overrides are applied to their
+   * match trees when they are switched to.
+   *
+   * Returns false and emits exception() if the override can not be parsed.
+   */
+  bool setOverride(const QString& selector,
+                   const QString& property,
+                   const QString& value);
+
+  /*! Removes the override for @p property set for @p selector */
+  void clearOverride(const QString& selector, const QString& property);
+
+  /*! Removes all overrides */
+  void clearOverrides();
+
+  /*! Sets the file caching the effective properties across sessions
+   *
+   * Whenever all styles are loaded and the file has been written for the
+   * same style sheets and overrides, the properties of the paths it contains
+   * are read from the file instead of being matched again.  unloadStyles()
+   * writes the properties resolved in this session back to the file on a
+   * background thread.  An empty url (the default) disables the cache.
+   */
+  void setStyleCacheSource(const QUrl& url);
+  QUrl styleCacheSource() const;
+
 Q_SIGNALS:
   /*! Fires when the style sheet is replaced or changed on the disk */
   void styleChanged();
@@ -131,38 +377,158 @@ class StyleEngine : public QObject
   void propertiesPotentiallyMissing();
 
 private:
-  StyleEngine() = default;
+  StyleEngine();
 
-  StyleSheet loadStyleSheet(const QUrl& srcurl);
-  void resolveFontFaceDecl(const StyleSheet& styleSheet);
+  using StyleSetPropsInstances = std::vector<std::shared_ptr<UsageCountedStyleSetProps>>;
+  using StyleSetPropsRefs = std::unordered_map<const PathNode*, StyleSetPropsRef>;
+
+  // property maps are shared with the snapshots taken from the engine
+  using PropertyMaps = std::unordered_map<const PathNode*, std::shared_ptr<PropertyMap>>;
+
+  //! A parsed style sheet and the hash of the file content it was parsed from
+  struct ParsedStyleSheet
+  {
+    QString mPath;
+    QByteArray mContentHash;
+    std::shared_ptr<const StyleSheet> mpStyleSheet;
+  };
+
+  //! A user style sheet compiled ahead of its use
+  struct CompiledStyleSheet
+  {
+    std::shared_ptr<const StyleSheet> mpStyleSheet;
+    //! the match tree with the style sheet on top of the other layers
+    std::shared_ptr<const IStyleMatchTree> mpStyleTree;
+    //! the effective property maps of the paths in use
+    PropertyMaps mPropertyMaps;
+  };
+
+  struct Override
+  {
+    std::string mSelector;
+    std::string mProperty;
+    std::string mValue;
+  };
+
+  struct PreloadedStyleSheet
+  {
+    QUrl mSourceUrl;
+    bool mInBackground = false;
+    QByteArray mContentHash;
+    //! the generation of the other layers compiled against
+    std::size_t mLayersGeneration = 0;
+    //! the overrides compiled with, see updatePreloadedOverrides()
+    std::shared_ptr<const StyleSheet> mpOverrides;
+    std::future<CompiledStyleSheet> mPendingCompilation;
+    CompiledStyleSheet mCompiled;
+  };
+
+  //! A style sheet layer: its source and the style sheet last loaded from it
+  struct StyleSheetLayer
+  {
+    QUrl mSourceUrl;
+    ParsedStyleSheet mStyleSheet;
+  };
+
+  bool loadStyleSheet(const QUrl& srcurl, ParsedStyleSheet& parsed);
+  std::vector<ParsedStyleSheet> parsedStyleSheets() const;
+  std::vector<std::size_t> loadChangedStyleSheets();
+  void applyStyleSheets(const std::vector<std::size_t>& changedLayers,
+                        const std::vector<ParsedStyleSheet>& previousStyleSheets);
+  void resolveFontFaceDecl(const StyleSheet& styleSheet, const QUrl& baseUrl);
   void reloadAllProperties();
+  void reloadTouchedProperties(const std::vector<StyleSheet>& changedRules,
+                               const std::vector<StyleSheet>& movedRules);
+  void reloadTouchedProperties(const std::function<bool(const UiItemPath&)>& isTouched,
+                               const std::function<bool(const UiItemPath&)>& isMoved);
+  bool isStyleTreeComplete() const;
+
+  static std::string overrideSource(const Override& entry);
+  void updateOverrides(const StyleSheet& changedRules);
 
-  PropertyMap* effectivePropertyMap(const UiItemPath& path);
+  std::vector<std::string> layerNames() const;
+
+  std::string styleCacheKey() const;
+  void openStyleCache();
+  void saveStyleCache();
+
+  PreloadedStyleSheet* preloadedStyleSheet(const QString& path,
+                                           const QByteArray& contentHash);
+  PreloadedStyleSheet* preloadedStyleTree(const ParsedStyleSheet& parsed);
+  void compileStyleSheet(const QString& path, PreloadedStyleSheet& preloaded);
+  void finishCompilation(PreloadedStyleSheet& preloaded);
+  void updatePreloadedOverrides(PreloadedStyleSheet& preloaded);
+  void recompilePreloadedStyleSheets();
+  void switchToPreloadedStyleSheet(const PreloadedStyleSheet& preloaded,
+                                   const QString& previousUserStyleSheetPath);
+
+  std::shared_ptr<PropertyMap> effectivePropertyMap(const PathNode* pPath);
 
   void notifyMissingProperties();
 
+  void countReload(std::chrono::steady_clock::time_point startTime);
+
 private:
-  using StyleSetPropsInstances = std::vector<std::shared_ptr<UsageCountedStyleSetProps>>;
-  using StyleSetPropsRefs =
-    std::unordered_map<UiItemPath, StyleSetPropsRef, UiItemPathHasher>;
+  using PreloadedStyleSheets = std::map<QString, PreloadedStyleSheet>;
 
-  using PropertyMapInstances = std::vector<std::unique_ptr<PropertyMap>>;
-  using PropertyMaps = std::unordered_map<UiItemPath, PropertyMap*, UiItemPathHasher>;
+  //! ordered by ascending precedence: the default style sheet comes first,
+  //! the user style sheet last
+  std::vector<StyleSheetLayer> mLayers;
 
-  QUrl mStyleSheetSourceUrl;
-  QUrl mDefaultStyleSheetSourceUrl;
+  //! the topmost layer of the match tree, above the user style sheet
+  std::vector<Override> mOverrides;
+  std::shared_ptr<const StyleSheet> mpOverrides;
 
   QUrl mBaseUrl;
   QStringList mImportPaths;
 
-  std::unique_ptr<IStyleMatchTree> mpStyleTree;
+  std::shared_ptr<const IStyleMatchTree> mpStyleTree;
+  //! keeps the profiled match layers alive
+  std::unique_ptr<IMatchProfile> mpMatchProfile;
+
+  std::shared_ptr<PathTrie> mpPathTrie;
+  std::unordered_map<const QMetaObject*, TypeElement> mTypeElements;
+
+  // compilations still running in the background refer to nodes of the path
+  // trie; declared after it to have them finished before the trie goes away
+  PreloadedStyleSheets mPreloadedStyleSheets;
+  //! changes whenever any layer but the user style sheet and the overrides changes
+  std::size_t mLayersGeneration = 0;
+
+  QUrl mStyleCacheSourceUrl;
+  //! the cache file matching the loaded styles, if any
+  std::unique_ptr<StyleCache> mpStyleCache;
+  std::future<void> mPendingStyleCacheWrite;
 
   StyleSetPropsInstances mStyleSetPropsInstances;
   StyleSetPropsRefs mStyleSetPropsRefs;
 
-  PropertyMapInstances mPropertyMapInstances;
   PropertyMaps mPropertyMaps;
 
+  std::shared_ptr<const StyleSnapshot> mpSnapshot;
+  //! the number of property maps copied into mpSnapshot
+  std::size_t mSnapshotPropertyMapCount = 0;
+
+  //! collect unused StyleSetProps when reaching this number of instances
+  std::size_t mStyleSetPropsCollectionSize;
+
+  Diagnostics mDiagnostics;
+  //! the interned missing property keys and their counters in
+  //! mMissingPropertyCounterSlots, whose elements never move
+  QHash<QString, std::atomic<std::size_t>*> mMissingPropertyCounters;
+  std::deque<std::atomic<std::size_t>> mMissingPropertyCounterSlots;
+  std::atomic<std::size_t> mConversionFailureCount{0};
+
+  std::size_t mPropertyMapHits = 0;
+  std::size_t mPropertyMapMisses = 0;
+  std::size_t mReloadCount = 0;
+  std::size_t mPreloadedSwitchCount = 0;
+  std::chrono::microseconds mLastReloadDuration{0};
+  std::chrono::microseconds mTotalReloadDuration{0};
+
+  int mUpdateDepth = 0;
+  bool mIsLoadPending = false;
+
   bool mHasStylesLoaded = false;
   bool mMissingPropertiesFound = false;
   bool mMissingPropertiesNotified = false;
@@ -37,14 +37,23 @@ namespace aqt
 {
 namespace stylesheets
 {
+namespace
+{
+const int kDefaultReloadDelay = 100;
+} // anon namespace
 
 StyleEngineSetup::StyleEngineSetup(QObject* pParent)
   : QObject(pParent)
   , mStylesDir(this)
+  , mStats(this)
 {
   connect(&mFsWatcher, &QFileSystemWatcher::fileChanged, this,
           &StyleEngineSetup::onFileChanged);
 
+  mReloadTimer.setSingleShot(true);
+  mReloadTimer.setInterval(kDefaultReloadDelay);
+  connect(&mReloadTimer, &QTimer::timeout, this, &StyleEngineSetup::onReloadTimeout);
+
   connect(&mStylesDir, &StylesDirWatcher::availableStylesChanged, this,
           &StyleEngineSetup::availableStylesChanged);
   connect(&mStylesDir, &StylesDirWatcher::fileExtensionsChanged, this,
@@ -58,6 +67,10 @@ StyleEngineSetup::StyleEngineSetup(QObject* pParent)
 
 StyleEngineSetup::~StyleEngineSetup()
 {
+  if (mIsUpdating) {
+    StyleEngine::instance().endUpdate();
+  }
+
   StyleEngine::instance().unloadStyles();
 }
 
@@ -95,6 +108,153 @@ void StyleEngineSetup::setDefaultStyleSheetSource(const QUrl& url)
   }
 }
 
+QList<QUrl> StyleEngineSetup::styleSheetLayers() const
+{
+  QList<QUrl> result;
+  for (const auto& sourceUrl : mStyleSheetLayerUrls) {
+    result.append(sourceUrl.url());
+  }
+
+  return result;
+}
+
+void StyleEngineSetup::setStyleSheetLayers(const QList<QUrl>& urls)
+{
+  if (styleSheetLayers() != urls) {
+    const auto layerCount = static_cast<std::size_t>(urls.size());
+
+    for (auto i = layerCount; i < mStyleSheetLayerUrls.size(); ++i) {
+      mStyleSheetLayerUrls[i].set(QUrl(), this, mFsWatcher);
+    }
+
+    mStyleSheetLayerUrls.resize(layerCount);
+    for (std::size_t i = 0; i < layerCount; ++i) {
+      const auto& url = urls[static_cast<int>(i)];
+      if (mStyleSheetLayerUrls[i].url() != url) {
+        mStyleSheetLayerUrls[i].set(url, this, mFsWatcher);
+      }
+    }
+
+    StyleEngine::instance().setStyleSheetLayerSources(urls);
+    StyleEngine::instance().loadStyles();
+
+    Q_EMIT styleSheetLayersChanged();
+  }
+}
+
+QVariantMap StyleEngineSetup::themes() const
+{
+  return mThemes;
+}
+
+void StyleEngineSetup::setThemes(const QVariantMap& themes)
+{
+  if (mThemes != themes) {
+    mThemes = themes;
+
+    if (!mIsUpdating) {
+      preloadThemes();
+    }
+    applyTheme();
+
+    Q_EMIT themesChanged();
+  }
+}
+
+QString StyleEngineSetup::theme() const
+{
+  return mTheme;
+}
+
+void StyleEngineSetup::setTheme(const QString& theme)
+{
+  if (mTheme != theme) {
+    mTheme = theme;
+
+    applyTheme();
+
+    Q_EMIT themeChanged();
+  }
+}
+
+bool StyleEngineSetup::preloadThemesInBackground() const
+{
+  return mPreloadThemesInBackground;
+}
+
+void StyleEngineSetup::setPreloadThemesInBackground(bool inBackground)
+{
+  if (mPreloadThemesInBackground != inBackground) {
+    mPreloadThemesInBackground = inBackground;
+
+    Q_EMIT preloadThemesInBackgroundChanged();
+  }
+}
+
+void StyleEngineSetup::preloadThemes()
+{
+  auto& engine = StyleEngine::instance();
+
+  engine.clearPreloadedStyleSheets();
+  for (const auto& name : mThemes.keys()) {
+    engine.preloadStyleSheet(mThemes.value(name).toUrl(), mPreloadThemesInBackground);
+  }
+}
+
+void StyleEngineSetup::applyTheme()
+{
+  if (mThemes.contains(mTheme)) {
+    setStyleSheetSource(mThemes.value(mTheme).toUrl());
+  }
+}
+
+int StyleEngineSetup::reloadDelay() const
+{
+  return mReloadTimer.interval();
+}
+
+void StyleEngineSetup::setReloadDelay(int msecs)
+{
+  if (mReloadTimer.interval() != msecs) {
+    mReloadTimer.setInterval(msecs);
+
+    Q_EMIT reloadDelayChanged();
+  }
+}
+
+QUrl StyleEngineSetup::styleCacheSource() const
+{
+  return StyleEngine::instance().styleCacheSource();
+}
+
+void StyleEngineSetup::setStyleCacheSource(const QUrl& url)
+{
+  if (styleCacheSource() != url) {
+    StyleEngine::instance().setStyleCacheSource(url);
+
+    Q_EMIT styleCacheSourceChanged();
+  }
+}
+
+bool StyleEngineSetup::profiling() const
+{
+  return StyleEngine::instance().profiling();
+}
+
+void StyleEngineSetup::setProfiling(bool isProfiling)
+{
+  if (profiling() != isProfiling) {
+    StyleEngine::instance().setProfiling(isProfiling);
+
+    Q_EMIT profilingChanged();
+  }
+}
+
+StyleEngineStats* StyleEngineSetup::stats()
+{
+  return &mStats;
+}
+
 QUrl StyleEngineSetup::stylePath() const
 {
   return mStylePathUrl;
@@ -176,18 +336,60 @@ QVariantList StyleEngineSetup::availableStyles()
   return mStylesDir.availableStyleSheetNames();
 }
 
-void StyleEngineSetup::onFileChanged(const QString&)
+bool StyleEngineSetup::setOverride(const QString& selector,
+                                   const QString& property,
+                                   const QString& value)
 {
-  StyleEngine::instance().loadStyles();
+  return StyleEngine::instance().setOverride(selector, property, value);
+}
+
+void StyleEngineSetup::clearOverride(const QString& selector, const QString& property)
+{
+  StyleEngine::instance().clearOverride(selector, property);
+}
+
+void StyleEngineSetup::clearOverrides()
+{
+  StyleEngine::instance().clearOverrides();
+}
+
+QString StyleEngineSetup::matchProfile() const
+{
+  return QString::fromStdString(StyleEngine::instance().matchProfile());
+}
+
+void StyleEngineSetup::onFileChanged(const QString& path)
+{
+  // Editors saving by replacing the file make the watcher drop the path
+  if (!mFsWatcher.files().contains(path) && QFile::exists(path)) {
+    mFsWatcher.addPath(path);
+  }
+
+  mReloadTimer.start();
+}
+
+void StyleEngineSetup::onReloadTimeout()
+{
+  StyleEngine::instance().reloadChangedStyles();
 }
 
 void StyleEngineSetup::classBegin()
 {
   StyleEngine::instance().bindToQmlEngine(*qmlEngine(parent()));
+
+  // Load the styles only once all initial properties have been set
+  StyleEngine::instance().beginUpdate();
+  mIsUpdating = true;
 }
 
 void StyleEngineSetup::componentComplete()
 {
+  mIsUpdating = false;
+  StyleEngine::instance().endUpdate();
+
+  // preload once the current styles are in use, so that the theme style
+  // sheets are compiled against them
+  preloadThemes();
 }
 
 void StyleEngineSetup::SourceUrl::set(const QUrl& url,
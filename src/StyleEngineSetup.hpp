@@ -22,6 +22,7 @@ THE SOFTWARE.
 
 #pragma once
 
+#include "StyleEngineStats.hpp"
 #include "StylesDirWatcher.hpp"
 #include "Warnings.hpp"
 
@@ -29,11 +30,15 @@ SUPPRESS_WARNINGS
 #include <QtCore/QFileSystemWatcher>
 #include <QtCore/QObject>
 #include <QtCore/QString>
+#include <QtCore/QTimer>
 #include <QtCore/QUrl>
 #include <QtCore/QVariantList>
+#include <QtCore/QVariantMap>
 #include <QtQml/QQmlParserStatus>
 RESTORE_WARNINGS
 
+#include <vector>
+
 namespace aqt
 {
 namespace stylesheets
@@ -167,6 +172,140 @@ class StyleEngineSetup : public QObject, public QQmlParserStatus
                setDefaultStyleSheetSource NOTIFY defaultStyleSheetSourceChanged
                  REVISION 1)
 
+  /*! @public Contains the source urls of additional style sheet layers
+   *
+   * The layers are stacked between the default style sheet and the style
+   * sheet given by styleSheetSource, ordered by ascending precedence.  For
+   * rules of the same specificity those from later layers win.  Each layer is
+   * actively watched like the other style sheets.  Replacing the source of a
+   * single layer only updates the StyleSet.props affected by the rules of the
+   * old or the new style sheet in that layer.
+   *
+   * @par Example
+   * @code
+   * StyleEngine {
+   *   defaultStyleSheetSource: "base.css"
+   *   styleSheetLayers: [ "platform.css",
+   *                       highContrast ? "high-contrast.css" : "normal.css" ]
+   *   styleSheetSource: "user.css"
+   * }
+   * @endcode
+   *
+   * @since 1.4
+   */
+  Q_PROPERTY(QList<QUrl> styleSheetLayers READ styleSheetLayers WRITE
+               setStyleSheetLayers NOTIFY styleSheetLayersChanged REVISION 4)
+
+  /*! @public Maps theme names to the urls of their style sheets
+   *
+   * All theme style sheets are preloaded: parsed, compiled and matched
+   * against the items in use ahead of time.  Switching the theme then only
+   * swaps in the precompiled styles and notifies the StyleSet.props whose
+   * properties actually change.
+   *
+   * @par Example
+   * @code
+   * StyleEngine {
+   *   defaultStyleSheetSource: "default.css"
+   *   themes: { "dark": "dark.css", "light": "light.css" }
+   *   theme: darkMode ? "dark" : "light"
+   * }
+   * @endcode
+   *
+   * @see theme
+   * @since 1.4
+   */
+  Q_PROPERTY(QVariantMap themes READ themes WRITE setThemes NOTIFY themesChanged
+               REVISION 4)
+
+  /*! @public Contains the name of the current theme
+   *
+   * Setting a theme listed in the themes property makes its style sheet the
+   * styleSheetSource.
+   *
+   * @since 1.4
+   */
+  Q_PROPERTY(QString theme READ theme WRITE setTheme NOTIFY themeChanged REVISION 4)
+
+  /*! @public Whether themes are preloaded on a background thread
+   *
+   * Defaults to true.  A theme switched to before its preloading has
+   * finished waits for it.
+   *
+   * @since 1.4
+   */
+  Q_PROPERTY(bool preloadThemesInBackground READ preloadThemesInBackground WRITE
+               setPreloadThemesInBackground NOTIFY preloadThemesInBackgroundChanged
+                 REVISION 4)
+
+  /*! @public Contains the delay in milliseconds before changed style sheets are reloaded
+   *
+   * Editors often write a file in several steps.  All changes to the watched
+   * style sheet files within this delay are coalesced into a single reload;
+   * style sheets whose content did not actually change are not parsed again.
+   * Defaults to 100 ms.
+   *
+   * @since 1.4
+   */
+  Q_PROPERTY(int reloadDelay READ reloadDelay WRITE setReloadDelay NOTIFY
+               reloadDelayChanged REVISION 4)
+
+  /*! @public Contains the url of a file caching resolved styles across runs
+   *
+   * Applications style the same items on every start.  With a style cache
+   * the engine writes the properties resolved during a run to this file when
+   * it shuts down, and reads them back on the next start instead of
+   * resolving them again, as long as none of the style sheets has changed.
+   * The URL must resolve to a local file path.  Defaults to an empty url,
+   * which disables the cache.
+   *
+   * @par Example
+   * @code
+   * StyleEngine {
+   *   styleSheetSource: "user.css"
+   *   styleCacheSource: StandardPaths.writableLocation(
+   *                       StandardPaths.CacheLocation) + "/styles.cache"
+   * }
+   * @endcode
+   *
+   * @since 1.4
+   */
+  Q_PROPERTY(QUrl styleCacheSource READ styleCacheSource WRITE setStyleCacheSource
+               NOTIFY styleCacheSourceChanged REVISION 4)
+
+  /*! @public Whether matching style rules is profiled
+   *
+   * While profiling, the engine records for every rule of the loaded style
+   * sheets how often it has been tested against an item, how much work has
+   * been spent on trying to match it, how often it matched and for how many
+   * items it contributed a property.  This helps finding expensive
+   * descendant selectors and rules which are never used.  Matching is
+   * slightly slower while profiling.  Defaults to false.
+   *
+   * @see matchProfile()
+   * @since 1.4
+   */
+  Q_PROPERTY(bool profiling READ profiling WRITE setProfiling NOTIFY profilingChanged
+               REVISION 4)
+
+  /*! @public Contains statistics about the style engine
+   *
+   * Lists the number of StyleSet.props and resolved paths, the size of the
+   * match tree built from the style sheets, how often properties have been
+   * looked up and converted, and how long reloading the style sheets took.
+   * The statistics are updated whenever the styles change and on
+   * StyleEngineStats::refresh().
+   *
+   * @par Example
+   * @code
+   * compare(styleEngine.stats.matchTreeBytes < 1024 * 1024, true)
+   * @endcode
+   *
+   * @see StyleEngineStats
+   * @since 1.4
+   */
+  Q_PROPERTY(aqt::stylesheets::StyleEngineStats* stats READ stats CONSTANT REVISION 4)
+
 public:
   /*! @cond DOXYGEN_IGNORE */
   explicit StyleEngineSetup(QObject* pParent = nullptr);
@@ -178,6 +317,29 @@ class StyleEngineSetup : public QObject, public QQmlParserStatus
   QUrl defaultStyleSheetSource() const;
   void setDefaultStyleSheetSource(const QUrl& url);
 
+  QList<QUrl> styleSheetLayers() const;
+  void setStyleSheetLayers(const QList<QUrl>& urls);
+
+  QVariantMap themes() const;
+  void setThemes(const QVariantMap& themes);
+
+  QString theme() const;
+  void setTheme(const QString& theme);
+
+  bool preloadThemesInBackground() const;
+  void setPreloadThemesInBackground(bool inBackground);
+
+  int reloadDelay() const;
+  void setReloadDelay(int msecs);
+
+  QUrl styleCacheSource() const;
+  void setStyleCacheSource(const QUrl& url);
+
+  bool profiling() const;
+  void setProfiling(bool isProfiling);
+
+  StyleEngineStats* stats();
+
   /*! @deprecated Use StylesDirWatcher instead. */
   QUrl stylePath() const;
   /*! @deprecated Use StylesDirWatcher instead. */
@@ -207,6 +369,63 @@ class StyleEngineSetup : public QObject, public QQmlParserStatus
   void componentComplete() override;
   /*! @endcond */
 
+  /*! Sets @p property to @p value for all items matching @p selector
+   *
+   * Overrides take precedence over all style sheets for rules of the same
+   * specificity.  They are applied without reloading any style sheet; only
+   * the StyleSet.props of items matching @p selector are updated.  Returns
+   * false if the override can not be parsed.
+   *
+   * @par Example
+   * @code
+   * StyleEngine {
+   *   id: styleEngine
+   * }
+   * ...
+   * onClicked: styleEngine.setOverride("QQuickText.title", "color", "red")
+   * @endcode
+   *
+   * @since 1.4
+   */
+  Q_REVISION(4) Q_INVOKABLE bool setOverride(const QString& selector,
+                                             const QString& property,
+                                             const QString& value);
+
+  /*! Removes the override for @p property set for @p selector
+   *
+   * @since 1.4
+   */
+  Q_REVISION(4) Q_INVOKABLE void clearOverride(const QString& selector,
+                                               const QString& property);
+
+  /*! Removes all overrides
+   *
+   * @since 1.4
+   */
+  Q_REVISION(4) Q_INVOKABLE void clearOverrides();
+
+  /*! Returns the results of profiling as a JSON string
+   *
+   * The result has a list of all rules, sorted by the work spent on them,
+   * and a list of all styled paths, sorted by the time spent on matching
+   * them.  The counts are kept per selector, as stated by the "granularity"
+   * field: rules with the same selector, even from different style sheets,
+   * are listed once with the source location of their first declaration.
+   * Returns an empty string if profiling is not enabled.
+   *
+   * @par Example
+   * @code
+   * var profile = JSON.parse(styleEngine.matchProfile());
+   * var unusedRules = profile.rules.filter(function(rule) {
+   *   return rule.matched === 0;
+   * });
+   * @endcode
+   *
+   * @see profiling
+   * @since 1.4
+   */
+  Q_REVISION(4) Q_INVOKABLE QString matchProfile() const;
+
 Q_SIGNALS:
   /*! Fires when the style sheet is replaced or changed on the disk */
   void styleChanged();
@@ -232,6 +451,46 @@ class StyleEngineSetup : public QObject, public QQmlParserStatus
    */
   Q_REVISION(1) void defaultStyleSheetSourceChanged(const QUrl& url);
 
+  /*! Emitted when the style sheet layer sources change.
+   *
+   * @since 1.4
+   */
+  Q_REVISION(4) void styleSheetLayersChanged();
+
+  /*! Emitted when the themes change.
+   *
+   * @since 1.4
+   */
+  Q_REVISION(4) void themesChanged();
+  /*! Emitted when the current theme changes.
+   *
+   * @since 1.4
+   */
+  Q_REVISION(4) void themeChanged();
+  /*! Emitted when preloadThemesInBackground changes.
+   *
+   * @since 1.4
+   */
+  Q_REVISION(4) void preloadThemesInBackgroundChanged();
+
+  /*! Emitted when the reload delay changes.
+   *
+   * @since 1.4
+   */
+  Q_REVISION(4) void reloadDelayChanged();
+
+  /*! Emitted when the style cache url changes.
+   *
+   * @since 1.4
+   */
+  Q_REVISION(4) void styleCacheSourceChanged();
+
+  /*! Emitted when profiling is started or stopped.
+   *
+   * @since 1.4
+   */
+  Q_REVISION(4) void profilingChanged();
+
   /*! Emitted when any part of the style sheet subsystem has to report some
    *  exceptional situation
    *
@@ -244,6 +503,7 @@ class StyleEngineSetup : public QObject, public QQmlParserStatus
 
 private Q_SLOTS:
   void onFileChanged(const QString& path);
+  void onReloadTimeout();
 
 private:
   class SourceUrl
@@ -265,6 +525,8 @@ private Q_SLOTS:
   };
 
   void updateSourceUrls();
+  void preloadThemes();
+  void applyTheme();
 
 private:
   QUrl mStylePathUrl;        //!< @deprecated
@@ -274,9 +536,18 @@ private Q_SLOTS:
 
   SourceUrl mStyleSheetSourceUrl;
   SourceUrl mDefaultStyleSheetSourceUrl;
+  std::vector<SourceUrl> mStyleSheetLayerUrls;
 
   QFileSystemWatcher mFsWatcher;
+  QTimer mReloadTimer;
   StylesDirWatcher mStylesDir;
+  StyleEngineStats mStats;
+
+  QVariantMap mThemes;
+  QString mTheme;
+  bool mPreloadThemesInBackground = true;
+
+  bool mIsUpdating = false;
 };
 
 } // namespace stylesheets
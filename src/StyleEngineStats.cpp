@@ -0,0 +1,126 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "StyleEngineStats.hpp"
+
+namespace aqt
+{
+namespace stylesheets
+{
+
+namespace
+{
+
+double toMilliseconds(std::chrono::microseconds duration)
+{
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+} // anon namespace
+
+StyleEngineStats::StyleEngineStats(QObject* pParent)
+  : QObject(pParent)
+{
+  connect(&StyleEngine::instance(), &StyleEngine::styleChanged, this,
+          &StyleEngineStats::refresh);
+  refresh();
+}
+
+qint64 StyleEngineStats::styleSetProps() const
+{
+  return static_cast<qint64>(mStats.styleSetPropsCount);
+}
+
+qint64 StyleEngineStats::cachedPaths() const
+{
+  return static_cast<qint64>(mStats.cachedPathCount);
+}
+
+qint64 StyleEngineStats::uniquePropertyMaps() const
+{
+  return static_cast<qint64>(mStats.uniquePropertyMapCount);
+}
+
+qint64 StyleEngineStats::matchTreeNodes() const
+{
+  return static_cast<qint64>(mStats.matchTreeNodeCount);
+}
+
+qint64 StyleEngineStats::matchTreeBytes() const
+{
+  return static_cast<qint64>(mStats.matchTreeByteCount);
+}
+
+qint64 StyleEngineStats::propertyMapHits() const
+{
+  return static_cast<qint64>(mStats.propertyMapHits);
+}
+
+qint64 StyleEngineStats::propertyMapMisses() const
+{
+  return static_cast<qint64>(mStats.propertyMapMisses);
+}
+
+double StyleEngineStats::propertyMapHitRate() const
+{
+  const auto lookups = mStats.propertyMapHits + mStats.propertyMapMisses;
+  return lookups > 0 ? static_cast<double>(mStats.propertyMapHits) / lookups : 0.0;
+}
+
+qint64 StyleEngineStats::conversions() const
+{
+  return static_cast<qint64>(mStats.conversionCount);
+}
+
+qint64 StyleEngineStats::conversionFailures() const
+{
+  return static_cast<qint64>(mStats.conversionFailureCount);
+}
+
+qint64 StyleEngineStats::reloads() const
+{
+  return static_cast<qint64>(mStats.reloadCount);
+}
+
+qint64 StyleEngineStats::preloadedSwitches() const
+{
+  return static_cast<qint64>(mStats.preloadedSwitchCount);
+}
+
+double StyleEngineStats::lastReloadDuration() const
+{
+  return toMilliseconds(mStats.lastReloadDuration);
+}
+
+double StyleEngineStats::totalReloadDuration() const
+{
+  return toMilliseconds(mStats.totalReloadDuration);
+}
+
+void StyleEngineStats::refresh()
+{
+  mStats = StyleEngine::instance().stats();
+  Q_EMIT changed();
+}
+
+} // namespace stylesheets
+} // namespace aqt
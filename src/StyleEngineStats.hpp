@@ -0,0 +1,142 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "StyleEngine.hpp"
+#include "Warnings.hpp"
+
+SUPPRESS_WARNINGS
+#include <QtCore/QObject>
+RESTORE_WARNINGS
+
+namespace aqt
+{
+namespace stylesheets
+{
+
+/*! Statistics of the style engine
+ *
+ * Exposes the counters of StyleEngine::stats() to QML, e.g. for a
+ * diagnostics overlay.  The values are taken whenever the styles change and
+ * when refresh() is called.  Counts of work done accumulate over the
+ * lifetime of the engine; durations are given in milliseconds.
+ *
+ * @par Example
+ * @code
+ * StyleEngine {
+ *   id: styleEngine
+ * }
+ *
+ * Timer {
+ *   interval: 1000; repeat: true; running: true
+ *   onTriggered: styleEngine.stats.refresh()
+ * }
+ *
+ * Text {
+ *   text: "paths: " + styleEngine.stats.cachedPaths
+ *         + ", hit rate: " + styleEngine.stats.propertyMapHitRate
+ * }
+ * @endcode
+ *
+ * @see StyleEngineSetup::stats
+ * @since 1.4
+ */
+class StyleEngineStats : public QObject
+{
+  Q_OBJECT
+  Q_DISABLE_COPY(StyleEngineStats)
+
+  /*! The number of StyleSetProps instances, unused ones not collected yet included */
+  Q_PROPERTY(qint64 styleSetProps READ styleSetProps NOTIFY changed)
+
+  /*! The number of paths with resolved properties */
+  Q_PROPERTY(qint64 cachedPaths READ cachedPaths NOTIFY changed)
+
+  /*! The number of distinct property maps shared by the cached paths */
+  Q_PROPERTY(qint64 uniquePropertyMaps READ uniquePropertyMaps NOTIFY changed)
+
+  /*! The number of match nodes built from the loaded style sheets */
+  Q_PROPERTY(qint64 matchTreeNodes READ matchTreeNodes NOTIFY changed)
+
+  /*! An estimate of the memory in bytes taken by the match nodes */
+  Q_PROPERTY(qint64 matchTreeBytes READ matchTreeBytes NOTIFY changed)
+
+  /*! The number of property lookups for paths resolved before */
+  Q_PROPERTY(qint64 propertyMapHits READ propertyMapHits NOTIFY changed)
+
+  /*! The number of property lookups for paths which had to be resolved */
+  Q_PROPERTY(qint64 propertyMapMisses READ propertyMapMisses NOTIFY changed)
+
+  /*! The share of property lookups for paths resolved before; 0 without lookups */
+  Q_PROPERTY(double propertyMapHitRate READ propertyMapHitRate NOTIFY changed)
+
+  /*! The number of property values converted */
+  Q_PROPERTY(qint64 conversions READ conversions NOTIFY changed)
+
+  /*! The number of property values which failed to convert */
+  Q_PROPERTY(qint64 conversionFailures READ conversionFailures NOTIFY changed)
+
+  /*! The number of loads and reloads of the style sheets */
+  Q_PROPERTY(qint64 reloads READ reloads NOTIFY changed)
+
+  /*! The number of reloads which switched to a preloaded style sheet */
+  Q_PROPERTY(qint64 preloadedSwitches READ preloadedSwitches NOTIFY changed)
+
+  /*! The duration of the last (re)load of the style sheets in milliseconds */
+  Q_PROPERTY(double lastReloadDuration READ lastReloadDuration NOTIFY changed)
+
+  /*! The duration of all (re)loads of the style sheets in milliseconds */
+  Q_PROPERTY(double totalReloadDuration READ totalReloadDuration NOTIFY changed)
+
+public:
+  /*! @cond DOXYGEN_IGNORE */
+  explicit StyleEngineStats(QObject* pParent = nullptr);
+
+  qint64 styleSetProps() const;
+  qint64 cachedPaths() const;
+  qint64 uniquePropertyMaps() const;
+  qint64 matchTreeNodes() const;
+  qint64 matchTreeBytes() const;
+  qint64 propertyMapHits() const;
+  qint64 propertyMapMisses() const;
+  double propertyMapHitRate() const;
+  qint64 conversions() const;
+  qint64 conversionFailures() const;
+  qint64 reloads() const;
+  qint64 preloadedSwitches() const;
+  double lastReloadDuration() const;
+  double totalReloadDuration() const;
+  /*! @endcond */
+
+  /*! Takes the current values from the style engine */
+  Q_INVOKABLE void refresh();
+
+Q_SIGNALS:
+  void changed();
+
+private:
+  StyleEngine::Stats mStats;
+};
+
+} // namespace stylesheets
+} // namespace aqt
@@ -26,6 +26,7 @@ THE SOFTWARE.
 #include "estd/memory.hpp"
 #include "Warnings.hpp"
 #include "Log.hpp"
+#include "Trace.hpp"
 
 SUPPRESS_WARNINGS
 #include <boost/assert.hpp>
@@ -36,12 +37,15 @@ SUPPRESS_WARNINGS
 RESTORE_WARNINGS
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <iostream>
+#include <set>
 #include <sstream>
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace aqt
@@ -71,7 +75,7 @@ using PropertyDefMap = std::unordered_map<std::string, Property>;
  * The tree is built upside down: A selector "A B C" leads to a tree
  * starting at the root "C".
  *
- * All selectors from all stylesheets are merged in one matchnode tree,
+ * All selectors from a style sheet are merged in one matchnode tree,
  * i.e. the two selectors "Gaz > Bar" and "Foo > Gaz > Bar" will result in
  * a match node tree like this (where "{}" denote the empty property
  * definition set):
@@ -117,15 +121,45 @@ class MatchNode
   Matches matches;
 };
 
+using MatchLayer = std::shared_ptr<const MatchNode>;
+
+/*! A match tree built from a stack of style sheet layers
+ *
+ * Every layer has its own tree of match nodes; the layers are only merged
+ * when matching a path.  Trees sharing a layer share its match nodes, which
+ * makes replacing a single layer cheap.
+ */
 class StyleMatchTree : public IStyleMatchTree
 {
 public:
-  StyleMatchTree()
-    : rootMatches(estd::make_unique<MatchNode>())
-  {
-  }
+  using Layers = std::vector<MatchLayer>;
 
-  std::unique_ptr<MatchNode> rootMatches;
+  Layers layers;
+};
+
+/*! Counts the work done matching paths against the nodes of match trees */
+class MatchProfile : public IMatchProfile
+{
+public:
+  struct NodeCounts {
+    //! how often the node has been searched for a child node
+    std::size_t lookups = 0;
+    //! how often the node has been reached
+    std::size_t visits = 0;
+    //! for how many paths the node contributed a winning property
+    std::size_t wins = 0;
+  };
+
+  struct PathCounts {
+    std::size_t count = 0;
+    std::chrono::nanoseconds time = std::chrono::nanoseconds(0);
+  };
+
+  //! keeps all profiled layers alive, so that no other node can reuse the
+  //! address of a profiled node
+  std::set<MatchLayer> layers;
+  std::unordered_map<const MatchNode*, NodeCounts> nodes;
+  std::unordered_map<std::string, PathCounts> paths;
 };
 
 PropertyDefMap makeProperties(const std::vector<PropertySpec>& props,
@@ -229,23 +263,119 @@ void mergePropSet(MatchNode* parent, int sourceLayer, const PropertySpecSet& ps)
 
 } // anon namespace
 
-#define DEFAULT_STYLESHEET_LAYER 0
-#define USER_STYLESHEET_LAYER 1
+namespace
+{
+
+MatchLayer createMatchLayer(const StyleSheet& stylesheet, const int sourceLayer)
+{
+  auto pRootMatches = estd::make_unique<MatchNode>();
+
+  for (const auto& ps : stylesheet.propsets) {
+    mergePropSet(pRootMatches.get(), sourceLayer, ps);
+  }
+
+  return std::move(pRootMatches);
+}
+
+} // anon namespace
+
+std::unique_ptr<IStyleMatchTree> createMatchTree(
+  const std::vector<const StyleSheet*>& stylesheets)
+{
+  AQT_STYLESHEETS_TRACE_SCOPE("createMatchTree");
+
+  auto result = estd::make_unique<StyleMatchTree>();
+
+  result->layers.reserve(stylesheets.size());
+  for (const auto* pStylesheet : stylesheets) {
+    result->layers.emplace_back(
+      createMatchLayer(pStylesheet ? *pStylesheet : StyleSheet(),
+                       static_cast<int>(result->layers.size())));
+  }
+
+  return std::move(result);
+}
 
 std::unique_ptr<IStyleMatchTree> createMatchTree(const StyleSheet& stylesheet,
                                                  const StyleSheet& defaultStylesheet)
 {
+  return createMatchTree({&defaultStylesheet, &stylesheet});
+}
+
+std::unique_ptr<IStyleMatchTree> replaceMatchTreeLayer(const IStyleMatchTree* itree,
+                                                       std::size_t layer,
+                                                       const StyleSheet& stylesheet)
+{
+  AQT_STYLESHEETS_TRACE_SCOPE("replaceMatchTreeLayer");
+
   auto result = estd::make_unique<StyleMatchTree>();
 
-  for (auto ps : defaultStylesheet.propsets) {
-    mergePropSet(result->rootMatches.get(), DEFAULT_STYLESHEET_LAYER, ps);
+  if (itree) {
+    result->layers = static_cast<const StyleMatchTree*>(itree)->layers;
+  }
+
+  BOOST_ASSERT(layer < result->layers.size());
+  result->layers[layer] = createMatchLayer(stylesheet, static_cast<int>(layer));
+
+  return std::move(result);
+}
+
+std::size_t matchTreeLayerCount(const IStyleMatchTree* itree)
+{
+  return itree ? static_cast<const StyleMatchTree*>(itree)->layers.size() : 0;
+}
+
+namespace
+{
+
+std::size_t heapBytes(const std::string& str)
+{
+  // short strings are stored inside the string object itself
+  const auto* pObject = reinterpret_cast<const char*>(&str);
+  const auto isInline = str.data() >= pObject && str.data() < pObject + sizeof(str);
+  return isInline ? 0 : str.capacity() + 1;
+}
+
+template <typename Map>
+std::size_t hashTableBytes(const Map& map)
+{
+  // every element lives in a node linked to the next one
+  return map.bucket_count() * sizeof(void*)
+         + map.size() * (sizeof(typename Map::value_type) + sizeof(void*));
+}
+
+void addMatchNodeSize(const MatchNode& node, MatchTreeSize& size)
+{
+  size.nodeCount += 1;
+  size.byteCount += sizeof(MatchNode) + hashTableBytes(node.properties)
+                    + hashTableBytes(node.matches);
+
+  for (const auto& element : node.properties) {
+    size.byteCount += heapBytes(element.first)
+                      + element.second.mValues.capacity() * sizeof(PropertyValue);
   }
 
-  for (auto ps : stylesheet.propsets) {
-    mergePropSet(result->rootMatches.get(), USER_STYLESHEET_LAYER, ps);
+  for (const auto& element : node.matches) {
+    size.byteCount += heapBytes(element.first);
+    addMatchNodeSize(*element.second, size);
   }
+}
 
-  return std::move(result);
+} // anon namespace
+
+MatchTreeSize matchTreeSize(const IStyleMatchTree* itree)
+{
+  auto result = MatchTreeSize{};
+
+  if (itree) {
+    for (const auto& pLayer : static_cast<const StyleMatchTree*>(itree)->layers) {
+      if (pLayer) {
+        addMatchNodeSize(*pLayer, result);
+      }
+    }
+  }
+
+  return result;
 }
 
 namespace
@@ -322,8 +452,14 @@ class MatchRec
   Nodes pNodes;
 };
 
-using MatchTuple = std::tuple<Specificity, PropertyDefMap>;
-using MatchResult = std::vector<MatchTuple>;
+using MatchTuple = std::tuple<Specificity, const MatchNode*>;
+
+class MatchResult : public std::vector<MatchTuple>
+{
+public:
+  //! records the matching work if not nullptr
+  MatchProfile* pProfile = nullptr;
+};
 
 void findDescendantMatchOnNode(MatchResult& result,
                                Specificity specificity,
@@ -353,21 +489,34 @@ Specificity getMatchSpecificity(const MatchTuple& tuple)
   return std::get<0>(tuple);
 }
 
-const PropertyDefMap& getMatchProperties(const MatchTuple& tuple)
+const MatchNode* getMatchNode(const MatchTuple& tuple)
 {
   return std::get<1>(tuple);
 }
 
+const PropertyDefMap& getMatchProperties(const MatchTuple& tuple)
+{
+  return getMatchNode(tuple)->properties;
+}
+
 MatchRec findPattern(MatchResult& result,
                      Specificity specificity,
                      const MatchNode* node,
                      const std::string& name)
 {
+  if (result.pProfile) {
+    ++result.pProfile->nodes[node].lookups;
+  }
+
   auto found = node->matches.find(name);
   if (found != node->matches.end()) {
     auto const* nd = found->second.get();
+    if (result.pProfile) {
+      ++result.pProfile->nodes[nd].visits;
+    }
+
     if (!nd->properties.empty()) {
-      result.emplace_back(std::make_tuple(specificity, nd->properties));
+      result.emplace_back(std::make_tuple(specificity, nd));
     }
 
     return MatchRec({std::make_tuple(specificity, nd)});
@@ -463,15 +612,30 @@ void findDescendantMatchOnNode(MatchResult& result,
   }
 }
 
-MatchResult findMatchingRules(const StyleMatchTree& tree, const UiItemPath& path)
+void findMatchingRules(MatchResult& result,
+                       const MatchNode* pRootMatches,
+                       const UiItemPath& path)
 {
-  MatchResult result;
-
   UiItemPath::const_reverse_iterator pathEltIter = path.rbegin();
   if (pathEltIter != path.rend()) {
-    findMatchOnNode(result, Specificity(), tree.rootMatches.get(), *pathEltIter,
+    findMatchOnNode(result, Specificity(), pRootMatches, *pathEltIter,
                     std::next(pathEltIter), path.rend());
   }
+}
+
+MatchResult findMatchingRules(const StyleMatchTree& tree,
+                              const UiItemPath& path,
+                              MatchProfile* pProfile = nullptr)
+{
+  MatchResult result;
+  result.pProfile = pProfile;
+
+  for (const auto& pLayer : tree.layers) {
+    if (pProfile) {
+      pProfile->layers.insert(pLayer);
+    }
+    findMatchingRules(result, pLayer.get(), path);
+  }
 
   return result;
 }
@@ -484,28 +648,49 @@ void sortMatchResults(MatchResult& result)
     });
 }
 
-using SourceLocationMap = std::unordered_map<std::string, SourceLocation>;
+using SourceLocationMap =
+  std::unordered_map<std::string, std::tuple<Specificity, SourceLocation>>;
 
-template <typename Pred>
-void mergePropertiesIntoPropertyMap(PropertyMap& dest,
-                                    const PropertyDefMap& defs,
+// Rules with a higher specificity win; for rules with the same specificity
+// the one defined later, i.e. in a higher layer or further down in the same
+// style sheet, wins.
+bool isLessSpecific(const std::tuple<Specificity, SourceLocation>& one,
+                    const Specificity& twoSpec,
+                    const SourceLocation& twoLoc)
+{
+  return std::get<0>(one) < twoSpec
+         || (std::get<0>(one) == twoSpec && std::get<1>(one) < twoLoc);
+}
+
+using WinnerMap = std::unordered_map<std::string, const MatchNode*>;
+
+void mergePropertiesIntoPropertyMap(PropertyDefMap& dest,
+                                    const MatchTuple& match,
                                     SourceLocationMap& locationMap,
-                                    Pred isPropLessSpecificPred)
+                                    WinnerMap* pWinners)
 {
-  for (auto const& propdef : defs) {
+  const auto& specificity = getMatchSpecificity(match);
+
+  for (auto const& propdef : getMatchProperties(match)) {
     auto foundIt = locationMap.find(propdef.first);
     if (foundIt == locationMap.end()
-        || isPropLessSpecificPred(foundIt->second, propdef.second.mSourceLoc)) {
-      dest[QString::fromStdString(propdef.first)] = propdef.second;
-      locationMap[propdef.first] = propdef.second.mSourceLoc;
+        || isLessSpecific(foundIt->second, specificity, propdef.second.mSourceLoc)) {
+      dest[propdef.first] = propdef.second;
+      locationMap[propdef.first] =
+        std::make_tuple(specificity, propdef.second.mSourceLoc);
+
+      if (pWinners) {
+        (*pWinners)[propdef.first] = getMatchNode(match);
+      }
     }
   }
 }
 
 PropertyMap mergeMatchResults(const MatchResult& result)
 {
-  PropertyMap props;
+  PropertyDefMap props;
   SourceLocationMap locationMap;
+  WinnerMap winners;
   Specificity lastSpec;
 
   for (const auto& tup : result) {
@@ -513,22 +698,54 @@ PropertyMap mergeMatchResults(const MatchResult& result)
                  || lastSpec == getMatchSpecificity(tup));
 
     mergePropertiesIntoPropertyMap(
-      props, getMatchProperties(tup), locationMap,
-      [&lastSpec, &tup](const SourceLocation& one, const SourceLocation& two) {
-        return lastSpec != getMatchSpecificity(tup) || one < two;
-      });
+      props, tup, locationMap, result.pProfile ? &winners : nullptr);
     lastSpec = getMatchSpecificity(tup);
   }
 
-  return props;
+  if (result.pProfile) {
+    std::set<const MatchNode*> winningNodes;
+    for (const auto& winner : winners) {
+      winningNodes.insert(winner.second);
+    }
+    for (const auto* pNode : winningNodes) {
+      ++result.pProfile->nodes[pNode].wins;
+    }
+  }
+
+  PropertyMap::Entries entries;
+  entries.reserve(props.size());
+  for (auto& propdef : props) {
+    entries.emplace_back(
+      QString::fromStdString(propdef.first), std::move(propdef.second));
+  }
+
+  return PropertyMap(std::move(entries));
 }
 
-std::ostream& operator<<(std::ostream& os, const SourceLocation& srcloc)
+std::string sourceLayerName(int sourceLayer, const std::vector<std::string>& layerNames)
 {
-  std::string sourceLayerName =
-    srcloc.mSourceLayer == 0 ? "default stylesheet" : "user stylesheet";
-  os << sourceLayerName << " at line " << srcloc.mLine << " column " << srcloc.mColumn;
-  return os;
+  const auto layer = static_cast<std::size_t>(sourceLayer);
+  if (layer < layerNames.size()) {
+    return layerNames[layer];
+  }
+
+  return "stylesheet layer " + std::to_string(sourceLayer);
+}
+
+std::vector<std::string> defaultLayerNames(std::size_t layerCount)
+{
+  std::vector<std::string> layerNames;
+  for (std::size_t layer = 0; layer < layerCount; ++layer) {
+    if (layer == 0) {
+      layerNames.emplace_back("default stylesheet");
+    } else if (layer + 1 == layerCount) {
+      layerNames.emplace_back("user stylesheet");
+    } else {
+      layerNames.emplace_back("stylesheet layer " + std::to_string(layer));
+    }
+  }
+
+  return layerNames;
 }
 
 std::ostream& operator<<(std::ostream& os, const PropertyValues& values)
@@ -568,27 +785,39 @@ std::ostream& operator<<(std::ostream& os, const PropertyValues& values)
 }
 
 void dumpPropertyDefMap(const PropertyDefMap& properties,
+                        const std::vector<std::string>& layerNames,
                         std::ostream& stream = std::cout)
 {
   stream << "{" << std::endl;
   for (const auto& it : properties) {
+    const auto& srcloc = it.second.mSourceLoc;
     stream << "  " << it.first << ": " << it.second.mValues << " //"
-           << it.second.mSourceLoc << std::endl;
+           << sourceLayerName(srcloc.mSourceLayer, layerNames) << " at line "
+           << srcloc.mLine << " column " << srcloc.mColumn << std::endl;
   }
   stream << "}" << std::endl;
 }
 
-void dumpMatchResults(const MatchResult& result, std::ostream& stream = std::cout)
+void dumpMatchResults(const MatchResult& result,
+                      const std::vector<std::string>& layerNames,
+                      std::ostream& stream = std::cout)
 {
   for (const auto& tup : result) {
     stream << "// specificity: " << getMatchSpecificity(tup) << std::endl;
-    dumpPropertyDefMap(getMatchProperties(tup), stream);
+    dumpPropertyDefMap(getMatchProperties(tup), layerNames, stream);
   }
 }
 
 } // anon namespace
 
 std::string describeMatchedPath(const IStyleMatchTree* itree, const UiItemPath& path)
+{
+  return describeMatchedPath(itree, path, defaultLayerNames(matchTreeLayerCount(itree)));
+}
+
+std::string describeMatchedPath(const IStyleMatchTree* itree,
+                                const UiItemPath& path,
+                                const std::vector<std::string>& layerNames)
 {
   if (itree) {
     const StyleMatchTree& tree = *static_cast<const StyleMatchTree*>(itree);
@@ -599,7 +828,7 @@ std::string describeMatchedPath(const IStyleMatchTree* itree, const UiItemPath&
 
     std::ostringstream stream;
     stream << "Style info for path " << path << std::endl;
-    dumpMatchResults(result, stream);
+    dumpMatchResults(result, layerNames, stream);
 
     return stream.str();
   }
@@ -609,15 +838,497 @@ std::string describeMatchedPath(const IStyleMatchTree* itree, const UiItemPath&
 
 PropertyMap matchPath(const IStyleMatchTree* itree, const UiItemPath& path)
 {
+  return matchPath(itree, path, nullptr);
+}
+
+PropertyMap matchPath(const IStyleMatchTree* itree,
+                      const UiItemPath& path,
+                      IMatchProfile* iprofile)
+{
+  using Clock = std::chrono::steady_clock;
+
+  auto* pProfile = static_cast<MatchProfile*>(iprofile);
+  const auto startTime = pProfile ? Clock::now() : Clock::time_point();
+
+  auto props = PropertyMap{};
   if (itree) {
     const StyleMatchTree& tree = *static_cast<const StyleMatchTree*>(itree);
 
-    MatchResult result = findMatchingRules(tree, path);
+    MatchResult result = findMatchingRules(tree, path, pProfile);
     sortMatchResults(result);
-    return mergeMatchResults(result);
+    props = mergeMatchResults(result);
+  }
+
+  if (pProfile) {
+    auto& counts = pProfile->paths[pathToString(path)];
+    ++counts.count;
+    counts.time += Clock::now() - startTime;
+  }
+
+  return props;
+}
+
+std::unique_ptr<IMatchProfile> createMatchProfile()
+{
+  return estd::make_unique<MatchProfile>();
+}
+
+namespace
+{
+
+std::string jsonString(const std::string& str)
+{
+  std::string result = "\"";
+  for (const auto c : str) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+    }
+    result += c;
   }
 
-  return PropertyMap{};
+  return result + "\"";
+}
+
+/*! Returns the selector of the rule ending at the node reached by @p keys
+ *
+ * The keys are in match tree order, i.e. the rightmost element comes first.
+ */
+std::string selectorText(const std::vector<const std::string*>& keys)
+{
+  std::string text;
+  auto needsChildCombinator = false;
+
+  for (const auto* pKey : boost::adaptors::reverse(keys)) {
+    if (*pKey == kDescendantAxisId) {
+      text += " ";
+      needsChildCombinator = false;
+    } else if (*pKey == kConjunctionIndicator) {
+      needsChildCombinator = false;
+    } else {
+      if (needsChildCombinator) {
+        text += " > ";
+      }
+      text += *pKey;
+      needsChildCombinator = true;
+    }
+  }
+
+  return text;
+}
+
+struct RuleProfile {
+  std::string selector;
+  SourceLocation sourceLoc;
+  std::size_t tested;
+  std::size_t steps;
+  std::size_t matched;
+  std::size_t won;
+};
+
+void collectRuleProfiles(std::vector<RuleProfile>& rules,
+                         const MatchProfile& profile,
+                         const MatchNode* pNode,
+                         std::vector<const std::string*>& keys,
+                         std::vector<const MatchNode*>& nodes)
+{
+  const auto counts = [&profile](const MatchNode* pCountedNode) {
+    const auto iCounts = profile.nodes.find(pCountedNode);
+    return iCounts != profile.nodes.end() ? iCounts->second
+                                          : MatchProfile::NodeCounts{};
+  };
+
+  for (const auto& match : pNode->matches) {
+    const auto* pChild = match.second.get();
+    keys.push_back(&match.first);
+    nodes.push_back(pChild);
+
+    if (!pChild->properties.empty()) {
+      auto rule = RuleProfile{};
+      rule.selector = selectorText(keys);
+      rule.sourceLoc = pChild->properties.begin()->second.mSourceLoc;
+      for (const auto& propdef : pChild->properties) {
+        rule.sourceLoc = std::min(rule.sourceLoc, propdef.second.mSourceLoc);
+      }
+
+      // the rule is tested whenever its rightmost element matches; all
+      // lookups on the way to its last node are spent on trying to match it
+      rule.tested = counts(nodes.front()).visits;
+      rule.steps = 0;
+      for (const auto* pChainNode : nodes) {
+        rule.steps += counts(pChainNode).lookups;
+      }
+      rule.matched = counts(pChild).visits;
+      rule.won = counts(pChild).wins;
+
+      rules.emplace_back(std::move(rule));
+    }
+
+    collectRuleProfiles(rules, profile, pChild, keys, nodes);
+
+    keys.pop_back();
+    nodes.pop_back();
+  }
+}
+
+} // anon namespace
+
+std::string matchProfileToJson(const IMatchProfile* iprofile,
+                               const IStyleMatchTree* itree,
+                               const std::vector<std::string>& layerNames)
+{
+  const auto& profile = *static_cast<const MatchProfile*>(iprofile);
+
+  std::vector<RuleProfile> rules;
+  if (itree) {
+    for (const auto& pLayer : static_cast<const StyleMatchTree*>(itree)->layers) {
+      std::vector<const std::string*> keys;
+      std::vector<const MatchNode*> nodes;
+      collectRuleProfiles(rules, profile, pLayer.get(), keys, nodes);
+    }
+  }
+
+  std::sort(
+    rules.begin(), rules.end(), [](const RuleProfile& lhs, const RuleProfile& rhs) {
+      return lhs.steps > rhs.steps
+             || (lhs.steps == rhs.steps && lhs.sourceLoc < rhs.sourceLoc);
+    });
+
+  using PathProfile = std::pair<std::string, MatchProfile::PathCounts>;
+  std::vector<PathProfile> paths(profile.paths.begin(), profile.paths.end());
+  std::sort(
+    paths.begin(), paths.end(), [](const PathProfile& lhs, const PathProfile& rhs) {
+      return lhs.second.time > rhs.second.time;
+    });
+
+  std::ostringstream stream;
+  // the counters are kept per match tree node, which merges all rules with
+  // the same selector
+  stream << "{\n  \"granularity\": \"selector\",\n  \"rules\": [";
+  for (std::size_t i = 0; i < rules.size(); ++i) {
+    const auto& rule = rules[i];
+    stream << (i == 0 ? "\n" : ",\n")
+           << "    {\"selector\": " << jsonString(rule.selector) << ", \"source\": "
+           << jsonString(sourceLayerName(rule.sourceLoc.mSourceLayer, layerNames))
+           << ", \"line\": " << rule.sourceLoc.mLine
+           << ", \"column\": " << rule.sourceLoc.mColumn
+           << ", \"tested\": " << rule.tested << ", \"steps\": " << rule.steps
+           << ", \"matched\": " << rule.matched << ", \"won\": " << rule.won << "}";
+  }
+  stream << "\n  ],\n  \"paths\": [";
+  for (std::size_t i = 0; i < paths.size(); ++i) {
+    const auto& path = paths[i];
+    const auto micros =
+      std::chrono::duration_cast<std::chrono::microseconds>(path.second.time).count();
+    stream << (i == 0 ? "\n" : ",\n")
+           << "    {\"path\": " << jsonString(path.first)
+           << ", \"count\": " << path.second.count << ", \"timeUs\": " << micros << "}";
+  }
+  stream << "\n  ]\n}\n";
+
+  return stream.str();
+}
+
+bool isPathMatchedByLayer(const IStyleMatchTree* itree,
+                          std::size_t layer,
+                          const UiItemPath& path)
+{
+  if (itree) {
+    const StyleMatchTree& tree = *static_cast<const StyleMatchTree*>(itree);
+
+    if (layer < tree.layers.size()) {
+      MatchResult result;
+      findMatchingRules(result, tree.layers[layer].get(), path);
+      return !result.empty();
+    }
+  }
+
+  return false;
+}
+
+PropertyMap::PropertyMap(Entries entries)
+  : mEntries(std::move(entries))
+{
+  using Entry = std::tuple<uint, QString, std::size_t>;
+
+  std::vector<Entry> order;
+  order.reserve(mEntries.size());
+  for (std::size_t i = 0; i < mEntries.size(); ++i) {
+    order.emplace_back(qHash(mEntries[i].first), mEntries[i].first, i);
+  }
+
+  // sorting by (hash, name, original index) keeps the first of several
+  // entries with the same name in front
+  std::sort(order.begin(), order.end());
+
+  Entries sorted;
+  sorted.reserve(order.size());
+  mHashes.reserve(order.size());
+
+  for (const auto& entry : order) {
+    if (sorted.empty() || mHashes.back() != std::get<0>(entry)
+        || sorted.back().first != std::get<1>(entry)) {
+      mHashes.push_back(std::get<0>(entry));
+      sorted.push_back(std::move(mEntries[std::get<2>(entry)]));
+    }
+  }
+
+  mEntries.swap(sorted);
+}
+
+PropertyMap::const_iterator PropertyMap::begin() const
+{
+  return mEntries.begin();
+}
+
+PropertyMap::const_iterator PropertyMap::end() const
+{
+  return mEntries.end();
+}
+
+PropertyMap::const_iterator PropertyMap::find(const QString& name) const
+{
+  const auto hash = qHash(name);
+  const auto hashesBegin = mHashes.begin();
+
+  for (auto it = std::lower_bound(hashesBegin, mHashes.end(), hash);
+       it != mHashes.end() && *it == hash; ++it) {
+    const auto entryIt = mEntries.begin() + std::distance(hashesBegin, it);
+    if (entryIt->first == name) {
+      return entryIt;
+    }
+  }
+
+  return mEntries.end();
+}
+
+std::size_t PropertyMap::size() const
+{
+  return mEntries.size();
+}
+
+bool PropertyMap::empty() const
+{
+  return mEntries.empty();
+}
+
+PropertyMap mergeInheritedProperties(const PropertyMap& props,
+                                     const PropertyMap& inheritedProps)
+{
+  PropertyMap::Entries entries;
+  entries.reserve(props.size() + inheritedProps.size());
+  entries.insert(entries.end(), props.begin(), props.end());
+  entries.insert(entries.end(), inheritedProps.begin(), inheritedProps.end());
+
+  return PropertyMap(std::move(entries));
+}
+
+bool haveSameValues(const PropertyMap& one, const PropertyMap& other)
+{
+  // both maps are ordered by the same criteria
+  return &one == &other
+         || (one.size() == other.size()
+             && std::equal(one.begin(), one.end(), other.begin(),
+                           [](const PropertyMap::value_type& lhs,
+                              const PropertyMap::value_type& rhs) {
+                             return lhs.first == rhs.first
+                                    && lhs.second.mValues == rhs.second.mValues;
+                           }));
+}
+
+namespace
+{
+
+bool haveSameProperties(const PropertySpec& one, const PropertySpec& other)
+{
+  return one.name == other.name && one.values == other.values;
+}
+
+bool haveSameRules(const PropertySpecSet& one, const PropertySpecSet& other)
+{
+  return one.selectors == other.selectors
+         && one.properties.size() == other.properties.size()
+         && std::equal(one.properties.begin(), one.properties.end(),
+                       other.properties.begin(), haveSameProperties);
+}
+
+bool isSameLocation(const SourceLocation& one, const SourceLocation& other)
+{
+  return one.mByteOfs == other.mByteOfs && one.mLine == other.mLine
+         && one.mColumn == other.mColumn;
+}
+
+//! Expects @p one and @p other to have the same rules
+bool haveSameLocations(const PropertySpecSet& one, const PropertySpecSet& other)
+{
+  return isSameLocation(one.mSourceLoc, other.mSourceLoc)
+         && std::equal(one.properties.begin(), one.properties.end(),
+                       other.properties.begin(),
+                       [](const PropertySpec& lhs, const PropertySpec& rhs) {
+                         return isSameLocation(lhs.mSourceLoc, rhs.mSourceLoc);
+                       });
+}
+
+/*! Returns the number of propsets with the same rules at the start and at the
+ *  end of both @p oldPropsets and @p newPropsets
+ */
+std::pair<std::size_t, std::size_t> commonHeadAndTail(
+  const std::vector<PropertySpecSet>& oldPropsets,
+  const std::vector<PropertySpecSet>& newPropsets)
+{
+  std::size_t head = 0;
+  while (head < oldPropsets.size() && head < newPropsets.size()
+         && haveSameRules(oldPropsets[head], newPropsets[head])) {
+    ++head;
+  }
+
+  std::size_t tail = 0;
+  while (tail < oldPropsets.size() - head && tail < newPropsets.size() - head
+         && haveSameRules(oldPropsets[oldPropsets.size() - tail - 1],
+                          newPropsets[newPropsets.size() - tail - 1])) {
+    ++tail;
+  }
+
+  return std::make_pair(head, tail);
+}
+
+/*! Collects the propsets not in the longest common subsequence of @p oldPropsets
+ *  and @p newPropsets into @p result
+ *
+ * This is the O(ND) difference algorithm by E. Myers.  Returns false if the
+ * sequences differ by more than @p maxEdits propsets.
+ */
+bool diffPropsets(const std::vector<PropertySpecSet>& oldPropsets,
+                  const std::vector<PropertySpecSet>& newPropsets,
+                  const int maxEdits,
+                  StyleSheet& result)
+{
+  const auto n = static_cast<int>(oldPropsets.size());
+  const auto m = static_cast<int>(newPropsets.size());
+  const auto offset = std::min(n + m, maxEdits) + 1;
+
+  // v[offset + k] is the furthest x reached on diagonal k = x - y
+  std::vector<int> v(static_cast<std::size_t>(2 * offset + 1), 0);
+  std::vector<std::vector<int>> trace;
+
+  const auto at = [offset](std::vector<int>& vec, int k) -> int& {
+    return vec[static_cast<std::size_t>(offset + k)];
+  };
+  const auto isDown = [&](std::vector<int>& vec, int d, int k) {
+    return k == -d || (k != d && at(vec, k - 1) < at(vec, k + 1));
+  };
+
+  for (auto d = 0; d <= std::min(n + m, maxEdits); ++d) {
+    trace.push_back(v);
+
+    for (auto k = -d; k <= d; k += 2) {
+      auto x = isDown(v, d, k) ? at(v, k + 1) : at(v, k - 1) + 1;
+      auto y = x - k;
+      while (x < n && y < m && haveSameRules(oldPropsets[static_cast<std::size_t>(x)],
+                                             newPropsets[static_cast<std::size_t>(y)])) {
+        ++x;
+        ++y;
+      }
+      at(v, k) = x;
+
+      if (x >= n && y >= m) {
+        // walk back through the edits, collecting them in reverse order
+        std::vector<const PropertySpecSet*> removed, added;
+        for (auto step = d; step > 0; --step) {
+          auto& stepV = trace[static_cast<std::size_t>(step)];
+          const auto stepK = x - y;
+          const auto prevK = isDown(stepV, step, stepK) ? stepK + 1 : stepK - 1;
+          const auto prevX = at(stepV, prevK);
+          const auto prevY = prevX - prevK;
+
+          if (prevK == stepK + 1) {
+            added.push_back(&newPropsets[static_cast<std::size_t>(prevY)]);
+          } else {
+            removed.push_back(&oldPropsets[static_cast<std::size_t>(prevX)]);
+          }
+          x = prevX;
+          y = prevY;
+        }
+
+        for (const auto* pPropset : boost::adaptors::reverse(removed)) {
+          result.propsets.push_back(*pPropset);
+        }
+        for (const auto* pPropset : boost::adaptors::reverse(added)) {
+          result.propsets.push_back(*pPropset);
+        }
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+} // anon namespace
+
+StyleSheet changedPropsets(const StyleSheet& oldStylesheet,
+                           const StyleSheet& newStylesheet)
+{
+  // Above this many changes most cached paths are touched anyway and it is
+  // cheaper to report all propsets between the common head and tail.
+  const auto kMaxEdits = 64;
+
+  const auto& oldPropsets = oldStylesheet.propsets;
+  const auto& newPropsets = newStylesheet.propsets;
+
+  std::size_t head = 0;
+  std::size_t tail = 0;
+  std::tie(head, tail) = commonHeadAndTail(oldPropsets, newPropsets);
+
+  using Propsets = std::vector<PropertySpecSet>;
+  const auto oldChanged =
+    Propsets(oldPropsets.begin() + static_cast<std::ptrdiff_t>(head),
+             oldPropsets.end() - static_cast<std::ptrdiff_t>(tail));
+  const auto newChanged =
+    Propsets(newPropsets.begin() + static_cast<std::ptrdiff_t>(head),
+             newPropsets.end() - static_cast<std::ptrdiff_t>(tail));
+
+  StyleSheet result;
+  if (!diffPropsets(oldChanged, newChanged, kMaxEdits, result)) {
+    result.propsets = oldChanged;
+    result.propsets.insert(result.propsets.end(), newChanged.begin(), newChanged.end());
+  }
+
+  return result;
+}
+
+StyleSheet movedPropsets(const StyleSheet& oldStylesheet,
+                         const StyleSheet& newStylesheet)
+{
+  const auto& oldPropsets = oldStylesheet.propsets;
+  const auto& newPropsets = newStylesheet.propsets;
+
+  std::size_t head = 0;
+  std::size_t tail = 0;
+  std::tie(head, tail) = commonHeadAndTail(oldPropsets, newPropsets);
+
+  StyleSheet result;
+  for (std::size_t i = 0; i < head; ++i) {
+    if (!haveSameLocations(oldPropsets[i], newPropsets[i])) {
+      result.propsets.push_back(newPropsets[i]);
+    }
+  }
+
+  // the propsets between the common head and tail are not paired up with
+  // their old counterparts; any of them might have moved
+  const auto oldTailStart = oldPropsets.size() - tail;
+  const auto newTailStart = newPropsets.size() - tail;
+  result.propsets.insert(result.propsets.end(),
+                         newPropsets.begin() + static_cast<std::ptrdiff_t>(head),
+                         newPropsets.begin() + static_cast<std::ptrdiff_t>(newTailStart));
+
+  for (std::size_t i = 0; i < tail; ++i) {
+    const auto& newPropset = newPropsets[newTailStart + i];
+    if (!haveSameLocations(oldPropsets[oldTailStart + i], newPropset)) {
+      result.propsets.push_back(newPropset);
+    }
+  }
+
+  return result;
 }
 
 std::ostream& operator<<(std::ostream& os, const UiItemPath& path)
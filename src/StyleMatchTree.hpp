@@ -28,13 +28,15 @@ THE SOFTWARE.
 #include "Warnings.hpp"
 
 SUPPRESS_WARNINGS
+#include <QtCore/QHash>
 #include <QtCore/QString>
 RESTORE_WARNINGS
 
-#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 /*! @cond DOXYGEN_IGNORE */
 
@@ -77,18 +79,170 @@ struct UiItemPathHasher {
 std::ostream& operator<<(std::ostream& os, const UiItemPath& path);
 std::string pathToString(const UiItemPath& path);
 
-using PropertyMap = std::map<QString, Property>;
+/*! An immutable, flat map from property names to properties
+ *
+ * The entries are stored in one contiguous vector ordered by the hash of
+ * their names (and by name for colliding hashes).  A lookup is a binary
+ * search over a parallel vector of hash values followed by a single string
+ * comparison in the common case.  Effective property maps are never changed
+ * once built, so no node based tree is needed.
+ */
+class PropertyMap
+{
+public:
+  using value_type = std::pair<QString, Property>;
+  using Entries = std::vector<value_type>;
+  using const_iterator = Entries::const_iterator;
+
+  PropertyMap() = default;
+
+  /*! Builds the map from @p entries
+   *
+   * If @p entries contains the same name more than once the first entry wins.
+   */
+  explicit PropertyMap(Entries entries);
+
+  const_iterator begin() const;
+  const_iterator end() const;
+  const_iterator find(const QString& name) const;
+
+  std::size_t size() const;
+  bool empty() const;
+
+private:
+  std::vector<uint> mHashes;
+  Entries mEntries;
+};
+
+/*! Returns @p props extended by all entries from @p inheritedProps not
+ *  overridden in @p props */
+PropertyMap mergeInheritedProperties(const PropertyMap& props,
+                                     const PropertyMap& inheritedProps);
+
+/*! Returns whether @p one and @p other map the same names to the same values
+ *
+ * Where the properties have been defined is not compared.
+ */
+bool haveSameValues(const PropertyMap& one, const PropertyMap& other);
+
+/*! Returns the propsets which differ between @p oldStylesheet and @p newStylesheet
+ *
+ * The result contains the propsets removed from @p oldStylesheet followed by
+ * the ones added to @p newStylesheet; a changed propset shows up in both.
+ * Propsets are compared by their selectors and properties and by their order.
+ * Where they are located in the style sheet is not compared, i.e. an edit
+ * shifting all following propsets down by a few lines only reports the edited
+ * propsets.  Any path not matched by the result is styled the same by both
+ * style sheets.
+ */
+StyleSheet changedPropsets(const StyleSheet& oldStylesheet,
+                           const StyleSheet& newStylesheet);
+
+/*! Returns the propsets of @p newStylesheet which are located elsewhere now
+ *
+ * Complements changedPropsets(): the result contains the propsets with the
+ * same rules as before whose source locations differ from the ones in
+ * @p oldStylesheet.  Paths matched by the result are styled the same by both
+ * style sheets, but their properties point to the old locations.  Propsets
+ * reported by changedPropsets() might show up in the result, too.
+ */
+StyleSheet movedPropsets(const StyleSheet& oldStylesheet,
+                         const StyleSheet& newStylesheet);
 
 class IStyleMatchTree
 {
 };
 
+/*! Creates a match tree with one layer per style sheet in @p stylesheets
+ *
+ * The layers are ordered by ascending precedence: for rules of the same
+ * specificity a rule from a later layer wins.  A nullptr stands for an empty
+ * style sheet.
+ */
+std::unique_ptr<IStyleMatchTree> createMatchTree(
+  const std::vector<const StyleSheet*>& stylesheets);
+
+/*! Creates a match tree with the two layers @p defaultStylesheet and @p stylesheet */
 std::unique_ptr<IStyleMatchTree> createMatchTree(
   const StyleSheet& stylesheet, const StyleSheet& defaultStylesheet = StyleSheet());
 
+/*! Returns a copy of @p tree with the layer @p layer built from @p stylesheet
+ *
+ * All other layers are shared with @p tree and not built again.
+ */
+std::unique_ptr<IStyleMatchTree> replaceMatchTreeLayer(const IStyleMatchTree* tree,
+                                                       std::size_t layer,
+                                                       const StyleSheet& stylesheet);
+
+std::size_t matchTreeLayerCount(const IStyleMatchTree* tree);
+
+/*! The number of match nodes of a match tree and the memory they take */
+struct MatchTreeSize
+{
+  std::size_t nodeCount = 0;
+  //! an estimate including the nodes' hash tables, names and properties
+  std::size_t byteCount = 0;
+};
+
+/*! Returns the size of all layers of @p tree */
+MatchTreeSize matchTreeSize(const IStyleMatchTree* tree);
+
+/*! Returns whether any rule from layer @p layer of @p tree matches @p path */
+bool isPathMatchedByLayer(const IStyleMatchTree* tree,
+                          std::size_t layer,
+                          const UiItemPath& path);
+
 PropertyMap matchPath(const IStyleMatchTree* tree, const UiItemPath& path);
+
+/*! Collects statistics about matching paths against match trees
+ *
+ * Counts per rule how often it has been tested, how many lookups have been
+ * spent on trying to match it, how often it matched and for how many paths
+ * it contributed at least one property to the result.  The time spent on
+ * matching is recorded per path.  A profile is not thread safe.
+ *
+ * The counts are kept per node of the match tree, i.e. per selector: rules
+ * with the same selector are merged into one node when the tree is built
+ * and can't be told apart anymore.
+ */
+class IMatchProfile
+{
+public:
+  virtual ~IMatchProfile() = default;
+};
+
+std::unique_ptr<IMatchProfile> createMatchProfile();
+
+/*! Same as matchPath() above, recording the work done in @p pProfile
+ *
+ * No profiling takes place if @p pProfile is nullptr.
+ */
+PropertyMap matchPath(const IStyleMatchTree* tree,
+                      const UiItemPath& path,
+                      IMatchProfile* pProfile);
+
+/*! Returns the statistics from @p profile for all rules of @p tree as JSON
+ *
+ * Lists the rules with the most lookups spent on them first, rules which
+ * never matched included, followed by the paths with the most time spent on
+ * them.  Sources are named by @p layerNames; lines and columns are counted
+ * from 0 as in describeMatchedPath().
+ *
+ * Each entry in "rules" stands for one selector (see IMatchProfile), which
+ * the JSON states as "granularity": "selector".  Several rules with the
+ * same selector are reported as one entry with the source location of the
+ * first of their declarations.
+ */
+std::string matchProfileToJson(const IMatchProfile* profile,
+                               const IStyleMatchTree* tree,
+                               const std::vector<std::string>& layerNames);
 std::string describeMatchedPath(const IStyleMatchTree* tree, const UiItemPath& path);
 
+/*! Same as above, naming the source of each property by @p layerNames */
+std::string describeMatchedPath(const IStyleMatchTree* tree,
+                                const UiItemPath& path,
+                                const std::vector<std::string>& layerNames);
+
 } // namespace stylesheets
 } // namespace aqt
 
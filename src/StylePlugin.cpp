@@ -24,6 +24,8 @@ THE SOFTWARE.
 
 #include "StyleChecker.hpp"
 #include "StyleEngineSetup.hpp"
+#include "StyleEngineStats.hpp"
+#include "StyleSchema.hpp"
 #include "StylesDirWatcher.hpp"
 #include "StyleSet.hpp"
 #include "StyleSetProps.hpp"
@@ -42,10 +44,16 @@ void aqt::stylesheets::StylePlugin::registerTypes(const char* pUri)
     pUri, 1, 0, "StyleSetProps", "Exposed as StyleSet.props");
   qmlRegisterUncreatableType<aqt::stylesheets::StyleSetProps, 2>(
     pUri, 1, 2, "StyleSetProps", "Exposed as StyleSet.props");
+  qmlRegisterUncreatableType<aqt::stylesheets::StyleSetProps, 4>(
+    pUri, 1, 4, "StyleSetProps", "Exposed as StyleSet.props");
   qmlRegisterType<aqt::stylesheets::StyleEngineSetup>(pUri, 1, 0, "StyleEngine");
   qmlRegisterType<aqt::stylesheets::StyleEngineSetup, 1>(pUri, 1, 1, "StyleEngine");
+  qmlRegisterType<aqt::stylesheets::StyleEngineSetup, 4>(pUri, 1, 4, "StyleEngine");
+  qmlRegisterUncreatableType<aqt::stylesheets::StyleEngineStats>(
+    pUri, 1, 4, "StyleEngineStats", "Exposed as StyleEngine.stats");
   qmlRegisterType<aqt::stylesheets::StylesDirWatcher>(pUri, 1, 1, "StylesDirWatcher");
   qmlRegisterType<aqt::stylesheets::StyleChecker>(pUri, 1, 3, "StyleChecker");
+  qmlRegisterType<aqt::stylesheets::StyleSchema>(pUri, 1, 4, "StyleSchema");
 }
 
 #if !defined(NOT_INCLUDE_MOC)
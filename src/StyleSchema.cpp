@@ -0,0 +1,209 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "StyleSchema.hpp"
+
+#include "Log.hpp"
+#include "StyleEngine.hpp"
+#include "StyleSetProps.hpp"
+
+SUPPRESS_WARNINGS
+#include <QtCore/QMetaType>
+RESTORE_WARNINGS
+
+#include <utility>
+
+namespace aqt
+{
+namespace stylesheets
+{
+
+namespace
+{
+
+int typeFromName(const QString& typeName)
+{
+  if (typeName == QLatin1String("color")) {
+    return QMetaType::QColor;
+  } else if (typeName == QLatin1String("number")) {
+    return QMetaType::Double;
+  } else if (typeName == QLatin1String("boolean")) {
+    return QMetaType::Bool;
+  } else if (typeName == QLatin1String("string")) {
+    return QMetaType::QString;
+  } else if (typeName == QLatin1String("font")) {
+    return QMetaType::QFont;
+  } else if (typeName == QLatin1String("url")) {
+    return QMetaType::QUrl;
+  }
+
+  return QMetaType::UnknownType;
+}
+
+} // anon namespace
+
+StyleSchema::StyleSchema(QObject* pParent)
+  : QObject(pParent)
+{
+  connect(&StyleEngine::instance(), &StyleEngine::styleChanged, this,
+          &StyleSchema::validateAll);
+}
+
+QVariantMap StyleSchema::properties() const
+{
+  return mProperties;
+}
+
+void StyleSchema::setProperties(const QVariantMap& properties)
+{
+  if (mProperties != properties) {
+    mProperties = properties;
+
+    mFields.clear();
+    for (const auto& key : mProperties.keys()) {
+      const auto typeName = mProperties.value(key).toString();
+      const auto type = typeFromName(typeName);
+
+      if (type == QMetaType::UnknownType) {
+        styleSheetsLogWarning() << "Unknown type '" << typeName.toStdString()
+                                << "' for style property " << key.toStdString();
+      }
+
+      mFields.push_back(Field{key, typeName, type});
+    }
+
+    Q_EMIT propertiesChanged();
+    validateAll();
+  }
+}
+
+QStringList StyleSchema::keys() const
+{
+  QStringList result;
+  for (const auto& field : mFields) {
+    result.append(field.mKey);
+  }
+  return result;
+}
+
+QStringList StyleSchema::errors() const
+{
+  return mErrors;
+}
+
+int StyleSchema::indexOf(const QString& key) const
+{
+  for (std::size_t i = 0; i < mFields.size(); ++i) {
+    if (mFields[i].mKey == key) {
+      return int(i);
+    }
+  }
+  return -1;
+}
+
+QVariantList StyleSchema::resolve(StyleSetProps* pProps)
+{
+  if (!pProps) {
+    return QVariantList();
+  }
+
+  auto iResolved = mResolved.find(pProps);
+  if (iResolved != mResolved.end() && iResolved->second.mpProps
+      && iResolved->second.mGeneration == pProps->generation()) {
+    return iResolved->second.mValues;
+  }
+
+  auto resolved = resolveFields(pProps);
+  const auto hasErrors = !resolved.mErrors.isEmpty();
+  auto values = resolved.mValues;
+
+  mResolved[pProps] = std::move(resolved);
+
+  if (hasErrors) {
+    updateErrors();
+  }
+
+  return values;
+}
+
+StyleSchema::Resolved StyleSchema::resolveFields(StyleSetProps* pProps) const
+{
+  const auto path = QString::fromStdString(pathToString(pProps->path()));
+
+  Resolved resolved{pProps, pProps->generation(), {}, {}};
+
+  for (const auto& field : mFields) {
+    auto value = pProps->typedValue(field.mKey, field.mType);
+
+    if (!value.isValid()) {
+      const auto isSet = pProps->property(field.mKey) != nullptr;
+      const auto message =
+        isSet ? QString::fromLatin1("Property '%1' is not convertible to a '%2' (%3)")
+                  .arg(field.mKey, field.mTypeName, path)
+              : QString::fromLatin1("Property '%1' not found (%2)").arg(field.mKey, path);
+
+      styleSheetsLogWarning() << message.toStdString();
+      Q_EMIT StyleEngine::instance().exception(
+        isSet ? QString::fromLatin1("propertyNotConvertible")
+              : QString::fromLatin1("propertyNotFound"),
+        message);
+
+      resolved.mErrors.append(message);
+    }
+
+    resolved.mValues.append(value);
+  }
+
+  return resolved;
+}
+
+void StyleSchema::validateAll()
+{
+  // re-resolve all paths this schema is in use for in one go, so that their
+  // problems are reported right after loading, not on the next lookup
+  for (auto iResolved = mResolved.begin(); iResolved != mResolved.end();) {
+    if (auto pProps = iResolved->second.mpProps.data()) {
+      iResolved->second = resolveFields(pProps);
+      ++iResolved;
+    } else {
+      iResolved = mResolved.erase(iResolved);
+    }
+  }
+
+  updateErrors();
+}
+
+void StyleSchema::updateErrors()
+{
+  QStringList errors;
+  for (const auto& resolved : mResolved) {
+    errors.append(resolved.second.mErrors);
+  }
+
+  if (mErrors != errors) {
+    mErrors = errors;
+    Q_EMIT errorsChanged();
+  }
+}
+
+} // namespace stylesheets
+} // namespace aqt
@@ -0,0 +1,145 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "Warnings.hpp"
+
+SUPPRESS_WARNINGS
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVariant>
+RESTORE_WARNINGS
+
+#include <unordered_map>
+#include <vector>
+
+namespace aqt
+{
+namespace stylesheets
+{
+
+class StyleSetProps;
+
+/*! Declares the style properties a component reads, together with their types
+ *
+ * Instead of looking up properties one by one, a component resolves all
+ * properties of a schema at once.  The values are converted to their declared
+ * types up front and are read by index afterwards.  Missing or unconvertible
+ * properties are reported once per path when a path is resolved and after
+ * every reload of the style sheet, not on each lookup.
+ *
+ * Supported types are "color", "number", "boolean", "string", "font" and
+ * "url".  The index of a property is its position in keys.
+ *
+ * @par Example
+ * @code
+ * StyleSchema {
+ *   id: buttonSchema
+ *   properties: { "background": "color", "radius": "number" }
+ * }
+ *
+ * Rectangle {
+ *   readonly property var style: buttonSchema.resolve(StyleSet.props)
+ *
+ *   color: style[buttonSchema.indexOf("background")]
+ *   radius: style[buttonSchema.indexOf("radius")]
+ * }
+ * @endcode
+ *
+ * @par Import in QML:
+ * <pre>
+ * import Aqt.StyleSheets 1.4
+ * </pre>
+ * @since 1.4
+ */
+class StyleSchema : public QObject
+{
+  Q_OBJECT
+
+  /*! The declared properties as a map from property names to type names */
+  Q_PROPERTY(
+    QVariantMap properties READ properties WRITE setProperties NOTIFY propertiesChanged)
+
+  /*! The names of the declared properties in index order */
+  Q_PROPERTY(QStringList keys READ keys NOTIFY propertiesChanged)
+
+  /*! The problems found for all paths this schema has been resolved for */
+  Q_PROPERTY(QStringList errors READ errors NOTIFY errorsChanged)
+
+public:
+  /*! @cond DOXYGEN_IGNORE */
+  explicit StyleSchema(QObject* pParent = nullptr);
+
+  QVariantMap properties() const;
+  void setProperties(const QVariantMap& properties);
+
+  QStringList keys() const;
+  QStringList errors() const;
+  /*! @endcond */
+
+  /*! Returns the index of property @p key or -1 if it is not declared */
+  Q_INVOKABLE int indexOf(const QString& key) const;
+
+  /*! Returns the values of all declared properties for @p pProps
+   *
+   * The values are converted to their declared types and are listed in index
+   * order.  Properties which are not set or not convertible are undefined.
+   */
+  Q_INVOKABLE QVariantList resolve(aqt::stylesheets::StyleSetProps* pProps);
+
+Q_SIGNALS:
+  void propertiesChanged();
+  void errorsChanged();
+
+  /*! @cond DOXYGEN_IGNORE */
+
+private:
+  struct Field {
+    QString mKey;
+    QString mTypeName;
+    int mType;
+  };
+
+  struct Resolved {
+    QPointer<StyleSetProps> mpProps;
+    std::size_t mGeneration;
+    QVariantList mValues;
+    QStringList mErrors;
+  };
+
+  Resolved resolveFields(StyleSetProps* pProps) const;
+  void validateAll();
+  void updateErrors();
+
+  QVariantMap mProperties;
+  std::vector<Field> mFields;
+  std::unordered_map<const StyleSetProps*, Resolved> mResolved;
+  QStringList mErrors;
+
+  /*! @endcond */
+};
+
+} // namespace stylesheets
+} // namespace aqt
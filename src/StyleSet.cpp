@@ -24,14 +24,18 @@ THE SOFTWARE.
 
 #include "Log.hpp"
 #include "StyleEngine.hpp"
+#include "Trace.hpp"
 #include "Warnings.hpp"
 
 SUPPRESS_WARNINGS
+#include <QtCore/QPointer>
+#include <QtCore/QTimer>
 #include <QtQuick/QQuickItem>
 RESTORE_WARNINGS
 
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 namespace aqt
 {
@@ -41,43 +45,9 @@ namespace stylesheets
 namespace
 {
 
-const std::string normalizeTypename(const std::string& tynm)
+StyleSet* attachedStyleSet(QObject* pObj)
 {
-  size_t pos = tynm.find("_QMLTYPE_");
-  if (pos != std::string::npos) {
-    return tynm.substr(0, pos);
-  }
-
-  pos = tynm.find("_QML_");
-  if (pos != std::string::npos) {
-    return tynm.substr(0, pos);
-  }
-  return tynm;
-}
-
-std::string typeName(QObject* obj)
-{
-  if (obj) {
-    const QMetaObject* meta = obj->metaObject();
-    return normalizeTypename(meta->className());
-  }
-  return "(null)";
-}
-
-std::vector<std::string> styleClassName(QObject* pObj)
-{
-  StyleSet* pStyleSet =
-    qobject_cast<StyleSet*>(qmlAttachedPropertiesObject<StyleSet>(pObj, false));
-
-  std::vector<std::string> classNames;
-
-  if (pStyleSet) {
-    for (auto className : pStyleSet->name().split(" ", QString::SkipEmptyParts)) {
-      classNames.emplace_back(className.toStdString());
-    }
-  }
-
-  return classNames;
+  return qobject_cast<StyleSet*>(qmlAttachedPropertiesObject<StyleSet>(pObj, false));
 }
 
 QObject* uiPathParent(QObject* pObj)
@@ -98,46 +68,52 @@ class CollectPath
 public:
   CollectPath(StyleSet* pStyleSet)
     : mpStyleSet(pStyleSet)
+    , mPathTrie(StyleEngine::instance().pathTrie())
+    , mpParentStyleSet(nullptr)
+    , mpLocalPath(mPathTrie.root())
   {
     QObject* pParent = pStyleSet->parent();
     Q_ASSERT(pParent);
     traverseParentChain(pParent);
   }
 
-  const UiItemPath& result() const
+  StyleSet* parentStyleSet() const
   {
-    return mResult;
+    return mpParentStyleSet;
+  }
+
+  const PathNode* localPath() const
+  {
+    return mpLocalPath;
   }
 
 private:
   void traverseParentChain(QObject* pObj)
   {
     if (pObj) {
-      if (StyleSet* pOtherStyleSet = otherStyleSet(pObj)) {
-        mResult = pOtherStyleSet->path();
+      StyleSet* pStyleSet = attachedStyleSet(pObj);
+      if (pStyleSet && pStyleSet != mpStyleSet) {
+        mpParentStyleSet = pStyleSet;
       } else {
         traverseParentChain(uiPathParent(pObj));
-        mResult.emplace_back(typeName(pObj), styleClassName(pObj));
+
+        if (pStyleSet) {
+          mpLocalPath = mPathTrie.intern(
+            mpLocalPath, pStyleSet->pathElement(), pStyleSet->pathElementHash());
+        } else {
+          const auto& type = StyleEngine::instance().typeElement(pObj->metaObject());
+          mpLocalPath = mPathTrie.intern(mpLocalPath, type.mElement, type.mHash);
+        }
       }
     }
   }
 
-  StyleSet* otherStyleSet(QObject* pObj)
-  {
-    auto* pStyleSet =
-      qobject_cast<StyleSet*>(qmlAttachedPropertiesObject<StyleSet>(pObj, false));
-    return pStyleSet != mpStyleSet ? pStyleSet : nullptr;
-  }
-
   StyleSet* mpStyleSet;
-  UiItemPath mResult;
+  PathTrie& mPathTrie;
+  StyleSet* mpParentStyleSet;
+  const PathNode* mpLocalPath;
 };
 
-UiItemPath traversePathUp(StyleSet* pStyleSet)
-{
-  return CollectPath(pStyleSet).result();
-}
-
 std::unordered_set<QObject*> allUniqueChildren(QObject* pParent)
 {
   using std::begin;
@@ -155,29 +131,58 @@ std::unordered_set<QObject*> allUniqueChildren(QObject* pParent)
   return result;
 }
 
-void propagatePathDown(QObject* pRoot)
+struct PendingPathPropagations {
+  std::vector<QPointer<StyleSet>> styleSets;
+  QPointer<QTimer> pTimer;
+  bool isFlushing = false;
+};
+
+PendingPathPropagations& pendingPathPropagations()
 {
-  const auto children = allUniqueChildren(pRoot);
+  static PendingPathPropagations sPending;
+  return sPending;
+}
 
-  for (auto pChild : children) {
-    if (uiPathParent(pChild) == pRoot) {
-      if (auto pStyleSet = qobject_cast<StyleSet*>(
-            qmlAttachedPropertiesObject<StyleSet>(pChild, false))) {
-        pStyleSet->refreshPath();
-      }
-      propagatePathDown(pChild);
-    }
-  }
+/*! The StyleSet created last, to share its path with the siblings following it
+ *
+ * Repeater and ListView create lots of sibling delegates of the same type,
+ * which all end up with the same path and the same props.  The entry is
+ * forgotten whenever a StyleSet changes in a way which might change the
+ * path of a new sibling.
+ */
+struct LastCreatedStyleSet {
+  QPointer<StyleSet> pStyleSet;
+  QPointer<QObject> pUiParent;
+  const QMetaObject* pMeta = nullptr;
+};
+
+LastCreatedStyleSet& lastCreatedStyleSet()
+{
+  static LastCreatedStyleSet sLastCreated;
+  return sLastCreated;
+}
+
+void forgetLastCreatedStyleSet()
+{
+  lastCreatedStyleSet().pStyleSet.clear();
 }
 
 } // anon namespace
 
 StyleSet::StyleSet(QObject* pParent)
   : QObject(pParent)
+  , mPathElement(std::string())
+  , mPathElementHash(0)
+  , mpLocalPath(nullptr)
+  , mpPath(nullptr)
+  , mIsPathStale(false)
+  , mIsPathPropagationPending(false)
 {
   QObject* p = parent();
   Q_ASSERT(p);
 
+  updatePathElement();
+
   QQuickItem* pItem = qobject_cast<QQuickItem*>(p);
   if (pItem != nullptr) {
     connect(pItem, &QQuickItem::parentChanged, this, &StyleSet::onParentChanged);
@@ -191,8 +196,36 @@ StyleSet::StyleSet(QObject* pParent)
       QString::fromLatin1("Hierarchy changes for this component won't be detected"));
   }
 
-  refreshPath();
-  propagatePathDown(p);
+  if (!sharePathWithSibling()) {
+    // a new StyleSet might be the closest parent StyleSet of later siblings
+    forgetLastCreatedStyleSet();
+    refreshPath();
+  }
+
+  auto& lastCreated = lastCreatedStyleSet();
+  lastCreated.pStyleSet = this;
+  lastCreated.pUiParent = uiPathParent(p);
+  lastCreated.pMeta = p->metaObject();
+
+  schedulePathPropagation();
+}
+
+bool StyleSet::sharePathWithSibling()
+{
+  const auto& lastCreated = lastCreatedStyleSet();
+  StyleSet* pSibling = lastCreated.pStyleSet;
+
+  if (!pSibling || pSibling->mIsPathStale || lastCreated.pMeta != parent()->metaObject()
+      || lastCreated.pUiParent != uiPathParent(parent())) {
+    return false;
+  }
+
+  setParentStyleSet(pSibling->mpParentStyleSet);
+  mpLocalPath = pSibling->mpLocalPath;
+  mpPath = pSibling->mpPath;
+  setupStyle(pSibling->mStyleSetPropsRef);
+
+  return true;
 }
 
 StyleSet* StyleSet::qmlAttachedProperties(QObject* pObject)
@@ -200,7 +233,7 @@ StyleSet* StyleSet::qmlAttachedProperties(QObject* pObject)
   return new StyleSet(pObject);
 }
 
-void StyleSet::setupStyle()
+void StyleSet::setupStyle(const StyleSetPropsRef& styleSetPropsRef)
 {
   auto pStyleSetProps = mStyleSetPropsRef.get();
 
@@ -209,12 +242,10 @@ void StyleSet::setupStyle()
       pStyleSetProps, &StyleSetProps::propsChanged, this, &StyleSet::propsChanged);
   }
 
-  mStyleSetPropsRef = StyleEngine::instance().styleSetProps(mPath);
+  mStyleSetPropsRef = styleSetPropsRef;
 
   pStyleSetProps = mStyleSetPropsRef.get();
   connect(pStyleSetProps, &StyleSetProps::propsChanged, this, &StyleSet::propsChanged);
-
-  Q_EMIT propsChanged();
 }
 
 QString StyleSet::name() const
@@ -222,58 +253,215 @@ QString StyleSet::name() const
   return mName;
 }
 
+const std::vector<std::string>& StyleSet::classNames() const
+{
+  return mPathElement.mClassNames;
+}
+
 void StyleSet::setName(const QString& val)
 {
   if (mName != val) {
     mName = val;
+    updatePathElement();
+
+    forgetLastCreatedStyleSet();
     refreshPath();
-    propagatePathDown(parent());
     Q_EMIT nameChanged(mName);
   }
 }
 
-const UiItemPath& StyleSet::path() const
+const PathNode* StyleSet::path()
 {
-  return mPath;
+  if (mIsPathStale) {
+    // pathChanged and propsChanged have been emitted when the path went stale
+    updatePath(false);
+  }
+  return mpPath;
 }
 
-QString StyleSet::pathString() const
+const PathElement& StyleSet::pathElement() const
 {
-  return QString::fromStdString(pathToString(mPath));
+  return mPathElement;
 }
 
-void StyleSet::refreshPath()
+std::size_t StyleSet::pathElementHash() const
 {
-  setPath(traversePathUp(this));
+  return mPathElementHash;
 }
 
-void StyleSet::setPath(const UiItemPath& path)
+void StyleSet::updatePathElement()
 {
-  if (mPath != path) {
-    mPath = path;
-    setupStyle();
+  const auto& type = StyleEngine::instance().typeElement(parent()->metaObject());
+
+  if (mName.isEmpty()) {
+    mPathElement = type.mElement;
+    mPathElementHash = type.mHash;
+  } else {
+    auto classNames = std::vector<std::string>{};
+    for (const auto& className : mName.split(" ", QString::SkipEmptyParts)) {
+      classNames.emplace_back(className.toStdString());
+    }
 
+    mPathElement = PathElement(type.mElement.mTypeName, classNames);
+    mPathElementHash = hash_value(mPathElement);
+  }
+}
+
+QString StyleSet::pathString()
+{
+  flushPendingPaths();
+  return QString::fromStdString(pathToString(path()));
+}
+
+bool StyleSet::refreshPath()
+{
+  AQT_STYLESHEETS_TRACE_SCOPE("refreshPath");
+
+  const auto collected = CollectPath(this);
+
+  setParentStyleSet(collected.parentStyleSet());
+  mpLocalPath = collected.localPath();
+
+  return updatePath(true);
+}
+
+void StyleSet::setParentStyleSet(StyleSet* pParentStyleSet)
+{
+  if (mpParentStyleSet != pParentStyleSet) {
+    if (mpParentStyleSet) {
+      disconnect(mpParentStyleSet.data(), &StyleSet::pathChanged, this,
+                 &StyleSet::onParentPathChanged);
+    }
+
+    mpParentStyleSet = pParentStyleSet;
+
+    if (mpParentStyleSet) {
+      connect(mpParentStyleSet.data(), &StyleSet::pathChanged, this,
+              &StyleSet::onParentPathChanged);
+    }
+  }
+}
+
+bool StyleSet::updatePath(bool notify)
+{
+  mIsPathStale = false;
+
+  auto& pathTrie = StyleEngine::instance().pathTrie();
+  const auto* pParentPath =
+    mpParentStyleSet ? mpParentStyleSet->path() : pathTrie.root();
+  const auto* pPath = pathTrie.concat(pParentPath, mpLocalPath);
+
+  if (mpPath == pPath) {
+    return false;
+  }
+
+  mpPath = pPath;
+  setupStyle(StyleEngine::instance().styleSetProps(mpPath));
+
+  if (notify) {
+    Q_EMIT propsChanged();
+    Q_EMIT pathChanged();
+  }
+
+  return true;
+}
+
+void StyleSet::onParentPathChanged()
+{
+  // Descendant StyleSets are connected to this one's pathChanged, so marking
+  // the path stale ripples down without walking the item tree.  This is not
+  // lazy: every StyleSet below is notified right away, since QML bindings to
+  // props have to be evaluated again.  Only resolving the paths is deferred.
+  if (!mIsPathStale) {
+    mIsPathStale = true;
+
+    Q_EMIT propsChanged();
     Q_EMIT pathChanged();
   }
 }
 
-QString StyleSet::styleInfo() const
+QString StyleSet::styleInfo()
 {
-  return QString::fromStdString(StyleEngine::instance().describeMatchedPath(mPath));
+  flushPendingPaths();
+  return QString::fromStdString(StyleEngine::instance().describeMatchedPath(path()));
 }
 
 StyleSetProps* StyleSet::props()
 {
+  flushPendingPaths();
+  path();
   return mStyleSetPropsRef.get();
 }
 
 void StyleSet::onParentChanged(QQuickItem* pNewParent)
 {
   if (pNewParent != nullptr) {
-    const auto newPath = traversePathUp(this);
-    if (mPath != newPath) {
-      setPath(newPath);
-      propagatePathDown(parent());
+    forgetLastCreatedStyleSet();
+    refreshPath();
+  }
+}
+
+void StyleSet::schedulePathPropagation()
+{
+  if (!mIsPathPropagationPending) {
+    mIsPathPropagationPending = true;
+
+    auto& pending = pendingPathPropagations();
+    pending.styleSets.emplace_back(this);
+
+    if (!pending.pTimer) {
+      // owned by the engine, so it goes away together with it
+      pending.pTimer = new QTimer(&StyleEngine::instance());
+      pending.pTimer->setSingleShot(true);
+      pending.pTimer->setInterval(0);
+      connect(pending.pTimer.data(), &QTimer::timeout, &StyleSet::flushPendingPaths);
+    }
+
+    if (!pending.pTimer->isActive()) {
+      pending.pTimer->start();
+    }
+  }
+}
+
+void StyleSet::flushPendingPaths()
+{
+  auto& pending = pendingPathPropagations();
+
+  if (pending.isFlushing) {
+    return;
+  }
+  pending.isFlushing = true;
+
+  // refreshing paths notifies QML, which might schedule further propagations
+  while (!pending.styleSets.empty()) {
+    auto styleSets = std::vector<QPointer<StyleSet>>{};
+    styleSets.swap(pending.styleSets);
+
+    for (const auto& pStyleSet : styleSets) {
+      if (pStyleSet && pStyleSet->mIsPathPropagationPending) {
+        pStyleSet->mIsPathPropagationPending = false;
+
+        AQT_STYLESHEETS_TRACE_SCOPE("propagatePathDown");
+        propagatePathDown(pStyleSet->parent());
+      }
+    }
+  }
+
+  pending.isFlushing = false;
+}
+
+void StyleSet::propagatePathDown(QObject* pRoot)
+{
+  const auto children = allUniqueChildren(pRoot);
+
+  for (auto pChild : children) {
+    if (uiPathParent(pChild) == pRoot) {
+      // StyleSets further down are relative to the first one on each branch
+      if (auto pStyleSet = attachedStyleSet(pChild)) {
+        pStyleSet->refreshPath();
+      } else {
+        propagatePathDown(pChild);
+      }
     }
   }
 }
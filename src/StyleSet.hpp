@@ -22,16 +22,20 @@ THE SOFTWARE.
 
 #pragma once
 
-#include "StyleMatchTree.hpp"
+#include "PathTrie.hpp"
 #include "StyleSetProps.hpp"
 #include "Warnings.hpp"
 
 SUPPRESS_WARNINGS
 #include <QtCore/QObject>
+#include <QtCore/QPointer>
 #include <QtCore/QString>
 #include <QtQml/qqml.h>
 RESTORE_WARNINGS
 
+#include <string>
+#include <vector>
+
 class QQuickItem;
 
 namespace aqt
@@ -177,15 +181,37 @@ class StyleSet : public QObject
   static StyleSet* qmlAttachedProperties(QObject* pObject);
 
   QString name() const;
+
+  /*! The style class names from name, split at blanks */
+  const std::vector<std::string>& classNames() const;
   void setName(const QString& val);
 
-  QString pathString() const;
-  const UiItemPath& path() const;
-  void refreshPath();
+  /*! The path element of the item this StyleSet is attached to
+   *
+   * Built from the item's type and classNames() whenever the name changes.
+   */
+  const PathElement& pathElement() const;
+  std::size_t pathElementHash() const;
+
+  QString pathString();
+
+  /*! Returns the absolute path, resolving it first if it is stale */
+  const PathNode* path();
+
+  /*! Rebinds to the closest StyleSet up the item tree and recomputes the
+   * path relative to it; returns true if the absolute path changed */
+  bool refreshPath();
+
+  /*! Rebinds the StyleSets below all newly created StyleSets
+   *
+   * This happens in batches, once per event loop turn or as soon as a
+   * StyleSet's path or props are read.
+   */
+  static void flushPendingPaths();
 
   StyleSetProps* props();
 
-  QString styleInfo() const;
+  QString styleInfo();
 
 /*! @endcond */
 
@@ -210,15 +236,35 @@ class StyleSet : public QObject
 
 private Q_SLOTS:
   void onParentChanged(QQuickItem* pNewParent);
+  void onParentPathChanged();
 
 private:
-  void setPath(const UiItemPath& path);
-  void setupStyle();
+  void setParentStyleSet(StyleSet* pParentStyleSet);
+  bool updatePath(bool notify);
+  bool sharePathWithSibling();
+  void setupStyle(const StyleSetPropsRef& styleSetPropsRef);
+  void schedulePathPropagation();
+  void updatePathElement();
+
+  static void propagatePathDown(QObject* pRoot);
 
 private:
   StyleSetPropsRef mStyleSetPropsRef;
   QString mName;
-  UiItemPath mPath;
+  PathElement mPathElement;
+  std::size_t mPathElementHash;
+
+  // The path is kept relative to the closest StyleSet up the item tree:
+  // mpLocalPath holds the elements from there down to this StyleSet's item.
+  // mpPath caches the absolute path; when the parent StyleSet's path changes
+  // it is marked stale and resolved again the next time it is read.  The
+  // notifications still reach every StyleSet below right away, see
+  // onParentPathChanged().
+  QPointer<StyleSet> mpParentStyleSet;
+  const PathNode* mpLocalPath;
+  const PathNode* mpPath;
+  bool mIsPathStale;
+  bool mIsPathPropagationPending;
 
   /*! @endcond */
 };
@@ -43,63 +43,131 @@ PropertyMap* nullProperties()
   return &sNullPropertyMap;
 }
 
+const Property& nullProperty()
+{
+  static const Property sNullProperty;
+  return sNullProperty;
+}
+
+template <typename T>
+QVariant toVariant(const boost::optional<T>& value)
+{
+  return value ? QVariant::fromValue(*value) : QVariant();
+}
+
+QVariant valuesToVariant(const PropertyValues& values)
+{
+  try {
+    if (values.size() == 1) {
+      return convertValueToVariant(values[0]);
+    }
+
+    return convertValueToVariantList(values);
+  } catch (ConvertException& e) {
+    if (StyleEngine::instance().countConversionFailure()) {
+      styleSheetsLogWarning() << e.what();
+    }
+  }
+
+  return QVariant();
+}
+
 } // anon namespace
 
-StyleSetProps::StyleSetProps(const UiItemPath& path)
-  : mPath(path)
-  , mpProperties(nullProperties())
+ReadOnlyPropertyMap::ReadOnlyPropertyMap(QObject* pParent)
+  : QQmlPropertyMap(this, pParent)
+{
+}
+
+QVariant ReadOnlyPropertyMap::updateValue(const QString& key, const QVariant& input)
+{
+  Q_UNUSED(input);
+  styleSheetsLogWarning() << "Style property " << key.toStdString()
+                          << " can not be changed";
+  return value(key);
+}
+
+StyleSetProps::StyleSetProps(const PathNode* pPath)
+  : mpPath(pPath)
+  , mpProperties(nullptr)
 {
-  loadProperties();
+}
+
+const PropertyMap& StyleSetProps::properties() const
+{
+  if (!mpProperties) {
+    mpProperties = StyleEngine::instance().properties(mpPath);
+  }
+
+  mHasBeenRead = true;
+  return *mpProperties;
 }
 
 bool StyleSetProps::isValid() const
 {
-  return !mpProperties->empty();
+  return !properties().empty();
 }
 
 bool StyleSetProps::isSet(const QString& key) const
 {
-  return mpProperties->find(key) != mpProperties->end();
+  const auto& props = properties();
+  return props.find(key) != props.end();
 }
 
-bool StyleSetProps::getImpl(Property& prop, const QString& key) const
+const Property* StyleSetProps::property(const QString& key) const
 {
-  PropertyMap::const_iterator it = mpProperties->find(key);
-  if (it != mpProperties->end()) {
-    prop = it->second;
-    return true;
+  const auto& props = properties();
+  PropertyMap::const_iterator it = props.find(key);
+  return it != props.end() ? &it->second : nullptr;
+}
+
+const Property* StyleSetProps::getImpl(const QString& key) const
+{
+  if (const auto* pProp = property(key)) {
+    return pProp;
   }
 
-  mMissingProps.insert(key);
-  StyleEngine::instance().setMissingPropertiesFound();
+  auto& engine = StyleEngine::instance();
+  if (engine.diagnostics() == StyleEngine::Diagnostics::Full) {
+    mMissingProps.insert(key);
+    engine.setMissingPropertiesFound();
+  } else {
+    engine.countMissingProperty(key);
+  }
 
-  return false;
+  return nullptr;
 }
 
 QVariant StyleSetProps::get(const QString& key) const
 {
-  Property prop;
-  getImpl(prop, key);
+  const auto* pProp = getImpl(key);
+  if (!pProp) {
+    return QVariant();
+  }
 
-  if (prop.mValues.size() == 1) {
+  if (pProp->mValues.size() == 1) {
     try {
-      auto conv = convertProperty<QString>(prop.mValues[0]);
+      auto conv = convertProperty<QString>(pProp->mValues[0]);
       if (conv) {
         return QVariant::fromValue(*conv);
       }
     } catch (ConvertException& e) {
-      styleSheetsLogWarning() << e.what();
+      if (countConversionFailure()) {
+        styleSheetsLogWarning() << e.what();
+      }
     }
-  } else if (prop.mValues.size() > 1) {
+  } else if (pProp->mValues.size() > 1) {
     QVariantList result;
-    for (const auto& propValue : prop.mValues) {
+    for (const auto& propValue : pProp->mValues) {
       try {
         auto conv = convertProperty<QString>(propValue);
         if (conv) {
           result.push_back(conv.get());
         }
       } catch (ConvertException& e) {
-        styleSheetsLogWarning() << e.what();
+        if (countConversionFailure()) {
+          styleSheetsLogWarning() << e.what();
+        }
       }
     }
 
@@ -111,20 +179,30 @@ QVariant StyleSetProps::get(const QString& key) const
 
 QVariant StyleSetProps::values(const QString& key) const
 {
-  Property prop;
-  getImpl(prop, key);
+  const auto* pProp = getImpl(key);
+  return valuesToVariant(pProp ? pProp->mValues : nullProperty().mValues);
+}
 
-  try {
-    if (prop.mValues.size() == 1) {
-      return convertValueToVariant(prop.mValues[0]);
-    }
+QObject* StyleSetProps::all()
+{
+  if (!mpAll) {
+    mpAll = new ReadOnlyPropertyMap(this);
 
-    return convertValueToVariantList(prop.mValues);
-  } catch (ConvertException& e) {
-    styleSheetsLogWarning() << e.what();
+    for (const auto& prop : properties()) {
+      mpAll->insert(prop.first, valuesToVariant(prop.second.mValues));
+    }
   }
 
-  return QVariant();
+  return mpAll;
+}
+
+void StyleSetProps::dropAll()
+{
+  if (mpAll) {
+    // QML might still hold on to it until its bindings are updated
+    mpAll->deleteLater();
+    mpAll = nullptr;
+  }
 }
 
 QColor StyleSetProps::color(const QString& key) const
@@ -154,38 +232,128 @@ QString StyleSetProps::string(const QString& key) const
 
 QUrl StyleSetProps::url(const QString& key) const
 {
-  Property prop;
-  auto url = lookupProperty<QUrl>(prop, key);
+  const auto* pProp = getImpl(key);
+  return resolveUrl(pProp, lookupProperty<QUrl>(pProp, key));
+}
 
+QUrl StyleSetProps::resolveUrl(const Property* pProp, const QUrl& url) const
+{
   auto& engine = StyleEngine::instance();
 
-  auto baseUrl = prop.mSourceLoc.mSourceLayer == 0 ? engine.defaultStyleSheetSource()
-                                                   : engine.styleSheetSource();
+  const auto sourceLayer = pProp ? pProp->mSourceLoc.mSourceLayer : 0;
+  auto baseUrl = engine.styleSheetLayerSource(static_cast<std::size_t>(sourceLayer));
   return engine.resolveResourceUrl(baseUrl, url);
 }
 
+bool StyleSetProps::countConversionFailure() const
+{
+  return StyleEngine::instance().countConversionFailure();
+}
+
+const QVariant* StyleSetProps::convertedValue(const Property* pProp, int typeId) const
+{
+  const auto iConverted =
+    std::find_if(mConvertedValues.begin(), mConvertedValues.end(),
+                 [&](const ConvertedValue& converted) {
+                   return converted.mpProperty == pProp && converted.mTypeId == typeId;
+                 });
+  return iConverted != mConvertedValues.end() ? &iConverted->mValue : nullptr;
+}
+
+void StyleSetProps::addConvertedValue(const Property* pProp,
+                                      int typeId,
+                                      const QVariant& value) const
+{
+  mConvertedValues.push_back(ConvertedValue{pProp, typeId, value});
+}
+
+const PathNode* StyleSetProps::path() const
+{
+  return mpPath;
+}
+
+std::size_t StyleSetProps::generation() const
+{
+  return mGeneration;
+}
+
+QVariant StyleSetProps::typedValue(const QString& key, int type) const
+{
+  const auto* pProp = property(key);
+  if (!pProp || pProp->mValues.size() != 1) {
+    return QVariant();
+  }
+
+  try {
+    switch (type) {
+    case QMetaType::QColor:
+      return toVariant(convertProperty<QColor>(pProp->mValues[0]));
+    case QMetaType::Double:
+      return toVariant(convertProperty<double>(pProp->mValues[0]));
+    case QMetaType::Bool:
+      return toVariant(convertProperty<bool>(pProp->mValues[0]));
+    case QMetaType::QString:
+      return toVariant(convertProperty<QString>(pProp->mValues[0]));
+    case QMetaType::QFont:
+      return toVariant(convertProperty<QFont>(pProp->mValues[0]));
+    case QMetaType::QUrl:
+      if (auto url = convertProperty<QUrl>(pProp->mValues[0])) {
+        return QVariant(resolveUrl(pProp, *url));
+      }
+      break;
+    default:
+      break;
+    }
+  } catch (const ConvertException&) {
+  }
+
+  return QVariant();
+}
+
 void StyleSetProps::loadProperties()
 {
   mMissingProps.clear();
-  mpProperties = StyleEngine::instance().properties(mPath);
-  Q_EMIT propsChanged();
+  mpProperties = nullptr;
+  mConvertedValues.clear();
+  dropAll();
+  ++mGeneration;
+
+  // nobody has seen the old properties, so nobody needs to learn about the
+  // new ones either
+  if (mHasBeenRead) {
+    Q_EMIT propsChanged();
+  }
+}
+
+void StyleSetProps::rebindProperties()
+{
+  mpProperties = nullptr;
+  mConvertedValues.clear();
 }
 
 void StyleSetProps::invalidate()
 {
   mMissingProps.clear();
   mpProperties = nullProperties();
+  mConvertedValues.clear();
+  dropAll();
+  ++mGeneration;
+}
+
+bool StyleSetProps::hasBeenRead() const
+{
+  return mHasBeenRead;
 }
 
 void StyleSetProps::checkProperties() const
 {
   for (const auto& key : mMissingProps) {
     styleSheetsLogWarning() << "Property " << key.toStdString() << " not found ("
-                            << pathToString(mPath) << ")";
+                            << pathToString(mpPath) << ")";
     Q_EMIT StyleEngine::instance().exception(
       QString::fromLatin1("propertyNotFound"),
       QString::fromLatin1("Property '%1' not found (%2)")
-        .arg(key, QString::fromStdString(pathToString(mPath))));
+        .arg(key, QString::fromStdString(pathToString(mpPath))));
   }
 
   mMissingProps.clear();
@@ -22,19 +22,23 @@ THE SOFTWARE.
 
 #pragma once
 
+#include "PathTrie.hpp"
 #include "StyleMatchTree.hpp"
 #include "Warnings.hpp"
 
 SUPPRESS_WARNINGS
 #include <QtCore/QObject>
+#include <QtCore/QPointer>
 #include <QtCore/QString>
 #include <QtCore/QUrl>
 #include <QtCore/QVariant>
 #include <QtGui/QColor>
 #include <QtGui/QFont>
+#include <QtQml/QQmlPropertyMap>
 RESTORE_WARNINGS
 
 #include <unordered_set>
+#include <vector>
 
 namespace aqt
 {
@@ -43,14 +47,52 @@ namespace stylesheets
 
 class StyleSet;
 
+/*! @cond DOXYGEN_IGNORE */
+
+/*! A QQmlPropertyMap which rejects all changes from QML */
+class ReadOnlyPropertyMap : public QQmlPropertyMap
+{
+  Q_OBJECT
+
+public:
+  explicit ReadOnlyPropertyMap(QObject* pParent = nullptr);
+
+protected:
+  QVariant updateValue(const QString& key, const QVariant& input) override;
+};
+
+/*! @endcond */
+
 /*! Provides style properties to QML via StyleSet */
 class StyleSetProps : public QObject
 {
   Q_OBJECT
 
+  /*! @public Contains all style properties at once
+   *
+   * A read-only map from property names to their values, with the values
+   * converted as values() does.  The map is built on first access after each
+   * reload of the style sheet and is shared by all items with the same path.
+   * Reading many properties from it is cheaper than calling the getters for
+   * each of them.
+   *
+   * @par Example:
+   * @code
+   * Rectangle {
+   *   property var style: StyleSet.props.all
+   *
+   *   color: style.background
+   *   border.color: style["border-color"]
+   * }
+   * @endcode
+   *
+   * @since 1.4
+   */
+  Q_PROPERTY(QObject* all READ all NOTIFY propsChanged REVISION 4)
+
 public:
   /*! @cond DOXYGEN_IGNORE */
-  explicit StyleSetProps(const UiItemPath& path);
+  explicit StyleSetProps(const PathNode* pPath);
   /*! @endcond */
 
   /*! Indicates whether this style set has any properties set */
@@ -266,22 +308,66 @@ class StyleSetProps : public QObject
   Q_REVISION(2) Q_INVOKABLE QUrl url(const QString& key) const;
 
   /*! @cond DOXYGEN_IGNORE */
+
+  QObject* all();
+
+  const PathNode* path() const;
+
+  /*! Counts the reloads and invalidations of the properties */
+  std::size_t generation() const;
+
+  /*! Returns the property @p key converted to @p type
+   *
+   * @p type is one of QMetaType::QColor, Double, Bool, QString, QFont or
+   * QUrl.  Returns an invalid QVariant if there's no property @p key or it is
+   * not convertible to @p type; neither is reported.
+   */
+  QVariant typedValue(const QString& key, int type) const;
+
+  /*! Returns the property @p key or nullptr if there's no such property
+   *
+   * Other than the getters above this does not report @p key as missing.
+   */
+  const Property* property(const QString& key) const;
+
+  /*! Drops the resolved properties
+   *
+   * The properties are resolved again on the next read access.  Emits
+   * propsChanged() only if this instance has been read from before.
+   */
   void loadProperties();
 
+  /*! Drops the resolved properties without notifying anybody
+   *
+   * For when the property map of this instance has been replaced by one with
+   * the same values.
+   */
+  void rebindProperties();
+
   void invalidate();
 
+  /*! Indicates whether the properties of this instance have been read */
+  bool hasBeenRead() const;
+
   void checkProperties() const;
 
 Q_SIGNALS:
   void propsChanged();
 
 private:
-  bool getImpl(Property& def, const QString& key) const;
+  const PropertyMap& properties() const;
+  void dropAll();
+  const Property* getImpl(const QString& key) const;
+
+  QUrl resolveUrl(const Property* pProp, const QUrl& url) const;
+  bool countConversionFailure() const;
+  const QVariant* convertedValue(const Property* pProp, int typeId) const;
+  void addConvertedValue(const Property* pProp, int typeId, const QVariant& value) const;
 
   template <typename T>
   T lookupProperty(const QString& key) const;
   template <typename T>
-  T lookupProperty(Property& def, const QString& key) const;
+  T lookupProperty(const Property* pProp, const QString& key) const;
 
 private:
   struct QStringHasher {
@@ -291,17 +377,32 @@ class StyleSetProps : public QObject
     }
   };
 
-  UiItemPath mPath;
-  PropertyMap* mpProperties;
+  const PathNode* mpPath;
+  //! nullptr until resolved on the first read access
+  mutable PropertyMap* mpProperties;
+  mutable bool mHasBeenRead = false;
+  //! nullptr until built on the first access to all
+  QPointer<ReadOnlyPropertyMap> mpAll;
+  std::size_t mGeneration = 0;
   mutable std::unordered_set<QString, QStringHasher> mMissingProps;
+
+  struct ConvertedValue {
+    const Property* mpProperty;
+    int mTypeId;
+    QVariant mValue;
+  };
+
+  //! the values converted on earlier reads of the properties in mpProperties;
+  //! only a handful of properties is read per instance
+  mutable std::vector<ConvertedValue> mConvertedValues;
   /*! @endcond */
 };
 
 /*! @cond DOXYGEN_IGNORE */
 
 struct UsageCountedStyleSetProps {
-  explicit UsageCountedStyleSetProps(const UiItemPath& path)
-    : styleSetProps{path}
+  explicit UsageCountedStyleSetProps(const PathNode* pPath)
+    : styleSetProps{pPath}
   {
   }
 
@@ -55,23 +55,37 @@ AQT_DEFINE_TYPENAME(QUrl);
 } // namespace detail
 
 template <typename T>
-T StyleSetProps::lookupProperty(Property& def, const QString& key) const
+T StyleSetProps::lookupProperty(const Property* pProp, const QString& key) const
 {
-  if (getImpl(def, key)) {
-    if (def.mValues.size() == 1) {
+  if (pProp) {
+    if (const auto* pConverted = convertedValue(pProp, qMetaTypeId<T>())) {
+      return qvariant_cast<T>(*pConverted);
+    }
+
+    auto hasBeenCounted = false;
+    auto isReported = false;
+
+    if (pProp->mValues.size() == 1) {
       try {
-        auto result = convertProperty<T>(def.mValues[0]);
+        auto result = convertProperty<T>(pProp->mValues[0]);
         if (result) {
+          addConvertedValue(pProp, qMetaTypeId<T>(), QVariant::fromValue(result.get()));
           return result.get();
         }
       } catch (const ConvertException& e) {
-        styleSheetsLogWarning() << e.what();
+        hasBeenCounted = true;
+        isReported = countConversionFailure();
+        if (isReported) {
+          styleSheetsLogWarning() << e.what();
+        }
       }
     }
 
-    styleSheetsLogWarning() << "Property " << key.toStdString()
-                            << " is not convertible to a '" << detail::TypeName<T>()()
-                            << "' (" << pathToString(mPath) << ")";
+    if (hasBeenCounted ? isReported : countConversionFailure()) {
+      styleSheetsLogWarning() << "Property " << key.toStdString()
+                              << " is not convertible to a '" << detail::TypeName<T>()()
+                              << "' (" << pathToString(mpPath) << ")";
+    }
   }
 
   return T();
@@ -80,8 +94,7 @@ T StyleSetProps::lookupProperty(Property& def, const QString& key) const
 template <typename T>
 T StyleSetProps::lookupProperty(const QString& key) const
 {
-  Property def;
-  return lookupProperty<T>(def, key);
+  return lookupProperty<T>(getImpl(key), key);
 }
 
 } // namespace stylesheets
@@ -0,0 +1,104 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "StyleSnapshot.hpp"
+
+#include "Warnings.hpp"
+
+SUPPRESS_WARNINGS
+#include <boost/assert.hpp>
+RESTORE_WARNINGS
+
+#include <utility>
+
+namespace aqt
+{
+namespace stylesheets
+{
+
+namespace
+{
+
+std::shared_ptr<const PropertyMap> emptyProperties()
+{
+  static const auto spEmpty = std::make_shared<const PropertyMap>();
+  return spEmpty;
+}
+
+std::shared_ptr<const PropertyMap> inheritProperties(
+  PropertyMap props, const std::shared_ptr<const PropertyMap>& pInheritedProps)
+{
+  if (props.empty()) {
+    return pInheritedProps;
+  }
+
+  return std::make_shared<const PropertyMap>(
+    mergeInheritedProperties(props, *pInheritedProps));
+}
+
+} // anon namespace
+
+StyleSnapshot::StyleSnapshot(std::shared_ptr<const IStyleMatchTree> pStyleTree,
+                             std::shared_ptr<const PathTrie> pPathTrie,
+                             PropertyMaps propertyMaps)
+  : mpStyleTree(std::move(pStyleTree))
+  , mpPathTrie(std::move(pPathTrie))
+  , mPropertyMaps(std::move(propertyMaps))
+{
+}
+
+std::shared_ptr<const PropertyMap> StyleSnapshot::properties(
+  const PathNode* pPath) const
+{
+  BOOST_ASSERT(pPath);
+
+  if (pPath->depth() == 0) {
+    return emptyProperties();
+  }
+
+  const auto iElement = mPropertyMaps.find(pPath);
+  if (iElement != mPropertyMaps.end()) {
+    return iElement->second;
+  }
+
+  return inheritProperties(
+    matchPath(mpStyleTree.get(), pPath->path()), properties(pPath->parent()));
+}
+
+std::shared_ptr<const PropertyMap> StyleSnapshot::properties(
+  const UiItemPath& path) const
+{
+  auto pProps = emptyProperties();
+
+  auto prefix = UiItemPath{};
+  prefix.reserve(path.size());
+
+  for (const auto& element : path) {
+    prefix.push_back(element);
+    pProps = inheritProperties(matchPath(mpStyleTree.get(), prefix), pProps);
+  }
+
+  return pProps;
+}
+
+} // namespace stylesheets
+} // namespace aqt
@@ -0,0 +1,81 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "PathTrie.hpp"
+#include "StyleMatchTree.hpp"
+
+#include <memory>
+#include <unordered_map>
+
+/*! @cond DOXYGEN_IGNORE */
+
+namespace aqt
+{
+namespace stylesheets
+{
+
+/*! An immutable view of the styles loaded at one point in time
+ *
+ * A snapshot shares the match tree and the effective property maps computed
+ * so far with the StyleEngine it has been taken from.  None of these is ever
+ * modified once built, so a snapshot can be queried from any thread without
+ * locking.  It stays valid when the engine reloads its styles, until the last
+ * reference to it is released.
+ *
+ * Properties for paths not cached in the snapshot are computed on every
+ * call and are not added to the snapshot.
+ */
+class StyleSnapshot
+{
+public:
+  using PropertyMaps =
+    std::unordered_map<const PathNode*, std::shared_ptr<const PropertyMap>>;
+
+  StyleSnapshot(std::shared_ptr<const IStyleMatchTree> pStyleTree,
+                std::shared_ptr<const PathTrie> pPathTrie,
+                PropertyMaps propertyMaps);
+
+  StyleSnapshot(const StyleSnapshot&) = delete;
+  StyleSnapshot& operator=(const StyleSnapshot&) = delete;
+
+  /*! Returns the effective properties for @p pPath; never nullptr
+   *
+   * @p pPath must have been interned in the path trie of the engine this
+   * snapshot has been taken from.
+   */
+  std::shared_ptr<const PropertyMap> properties(const PathNode* pPath) const;
+
+  /*! Returns the effective properties for @p path; never nullptr */
+  std::shared_ptr<const PropertyMap> properties(const UiItemPath& path) const;
+
+private:
+  std::shared_ptr<const IStyleMatchTree> mpStyleTree;
+  std::shared_ptr<const PathTrie> mpPathTrie;
+  PropertyMaps mPropertyMaps;
+};
+
+} // namespace stylesheets
+} // namespace aqt
+
+/*! @endcond */
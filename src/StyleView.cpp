@@ -0,0 +1,153 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "StyleView.hpp"
+
+#include "Property.hpp"
+#include "StyleSet.hpp"
+#include "StyleSetProps.hpp"
+
+SUPPRESS_WARNINGS
+#include <QtQml/qqml.h>
+RESTORE_WARNINGS
+
+#include <memory>
+#include <utility>
+
+namespace aqt
+{
+namespace stylesheets
+{
+
+namespace
+{
+
+/*! The values of one property as far as change detection is concerned */
+struct PropertyState {
+  bool mIsSet = false;
+  PropertyValues mValues;
+
+  bool update(const Property* pProp)
+  {
+    const auto isSet = pProp != nullptr;
+    if (isSet == mIsSet && (!isSet || pProp->mValues == mValues)) {
+      return false;
+    }
+
+    mIsSet = isSet;
+    mValues = isSet ? pProp->mValues : PropertyValues{};
+    return true;
+  }
+};
+
+} // anon namespace
+
+StyleView::StyleView(QObject* pObject)
+  : mpStyleSet(
+      qobject_cast<StyleSet*>(qmlAttachedPropertiesObject<StyleSet>(pObject, true)))
+{
+}
+
+StyleSetProps* StyleView::props() const
+{
+  return mpStyleSet ? mpStyleSet->props() : nullptr;
+}
+
+bool StyleView::isSet(const QString& key) const
+{
+  auto pProps = props();
+  return pProps ? pProps->isSet(key) : false;
+}
+
+QColor StyleView::color(const QString& key) const
+{
+  auto pProps = props();
+  return pProps ? pProps->color(key) : QColor();
+}
+
+bool StyleView::boolean(const QString& key) const
+{
+  auto pProps = props();
+  return pProps ? pProps->boolean(key) : false;
+}
+
+double StyleView::number(const QString& key) const
+{
+  auto pProps = props();
+  return pProps ? pProps->number(key) : 0.0;
+}
+
+QFont StyleView::font(const QString& key) const
+{
+  auto pProps = props();
+  return pProps ? pProps->font(key) : QFont();
+}
+
+QString StyleView::string(const QString& key) const
+{
+  auto pProps = props();
+  return pProps ? pProps->string(key) : QString();
+}
+
+QUrl StyleView::url(const QString& key) const
+{
+  auto pProps = props();
+  return pProps ? pProps->url(key) : QUrl();
+}
+
+QMetaObject::Connection StyleView::onChanged(QObject* pContext,
+                                             std::function<void()> callback) const
+{
+  if (!mpStyleSet) {
+    return {};
+  }
+
+  // StyleSetProps only report changes once they have been read from
+  props()->isValid();
+
+  return QObject::connect(
+    mpStyleSet.data(), &StyleSet::propsChanged, pContext, std::move(callback));
+}
+
+QMetaObject::Connection StyleView::onChanged(const QString& key,
+                                             QObject* pContext,
+                                             std::function<void()> callback) const
+{
+  if (!mpStyleSet) {
+    return {};
+  }
+
+  auto pState = std::make_shared<PropertyState>();
+  pState->update(props()->property(key));
+
+  auto pStyleSet = mpStyleSet;
+  return QObject::connect(mpStyleSet.data(), &StyleSet::propsChanged, pContext,
+                          [pStyleSet, key, pState, callback]() {
+                            if (pStyleSet
+                                && pState->update(pStyleSet->props()->property(key))) {
+                              callback();
+                            }
+                          });
+}
+
+} // namespace stylesheets
+} // namespace aqt
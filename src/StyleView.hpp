@@ -0,0 +1,130 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "Warnings.hpp"
+
+SUPPRESS_WARNINGS
+#include <QtCore/QMetaObject>
+#include <QtCore/QPointer>
+#include <QtCore/QString>
+#include <QtCore/QUrl>
+#include <QtGui/QColor>
+#include <QtGui/QFont>
+RESTORE_WARNINGS
+
+#include <functional>
+
+namespace aqt
+{
+namespace stylesheets
+{
+
+class StyleSet;
+class StyleSetProps;
+
+/*! Typed access to the style properties of an item from C++
+ *
+ * Gives C++ items the same properties QML code gets from StyleSet.props,
+ * without going through the meta object system:
+ *
+ * @par Example:
+ * @code
+ * // GUI thread: read the style and keep plain values for rendering
+ * void MyItem::componentComplete()
+ * {
+ *   QQuickItem::componentComplete();
+ *
+ *   mpStyle.reset(new StyleView(this));
+ *   mBackground = mpStyle->color("background");
+ *   mpStyle->onChanged("background", this, [this] {
+ *     mBackground = mpStyle->color("background");
+ *     update();
+ *   });
+ * }
+ *
+ * // Render thread: only use the plain values
+ * QSGNode* MyItem::updatePaintNode(QSGNode* pOldNode, UpdatePaintNodeData*)
+ * {
+ *   auto pNode = static_cast<QSGSimpleRectNode*>(pOldNode);
+ *   ...
+ *   pNode->setColor(mBackground);
+ *   return pNode;
+ * }
+ * @endcode
+ *
+ * A StyleView attaches a StyleSet to @p pObject if it doesn't have one yet.
+ * The getters behave like their StyleSetProps counterparts and return a
+ * default constructed value if the property is not set or not convertible.
+ * Converted values are cached per StyleSet until the style changes, so
+ * repeated reads of the same key don't convert again; url() is resolved on
+ * every call.
+ *
+ * Construct and use a StyleView on the GUI thread only.  updatePaintNode()
+ * runs on the render thread: hand the values over as plain members as
+ * above, or see StyleEngine::snapshot() for reading styles from other
+ * threads.
+ *
+ * The header is installed with the AqtStyleSheets library, which C++
+ * clients link against.
+ */
+class StyleView
+{
+public:
+  explicit StyleView(QObject* pObject);
+
+  /*! Indicates whether a style property @p key is defined */
+  bool isSet(const QString& key) const;
+
+  QColor color(const QString& key) const;
+  bool boolean(const QString& key) const;
+  double number(const QString& key) const;
+  QFont font(const QString& key) const;
+  QString string(const QString& key) const;
+  QUrl url(const QString& key) const;
+
+  /*! Calls @p callback whenever any style property might have changed
+   *
+   * The connection is released when @p pContext is destroyed.
+   */
+  QMetaObject::Connection onChanged(QObject* pContext,
+                                    std::function<void()> callback) const;
+
+  /*! Calls @p callback whenever the value of style property @p key changed
+   *
+   * Changes of the path or reloads of the style sheet which leave the value
+   * of @p key as it is don't call @p callback.  The connection is released
+   * when @p pContext is destroyed.
+   */
+  QMetaObject::Connection onChanged(const QString& key,
+                                    QObject* pContext,
+                                    std::function<void()> callback) const;
+
+private:
+  StyleSetProps* props() const;
+
+  QPointer<StyleSet> mpStyleSet;
+};
+
+} // namespace stylesheets
+} // namespace aqt
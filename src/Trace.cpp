@@ -0,0 +1,101 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "Trace.hpp"
+
+#include "estd/memory.hpp"
+#include "Log.hpp"
+
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace aqt
+{
+namespace stylesheets
+{
+namespace
+{
+const char* const kTraceFileVariable = "AQT_STYLESHEETS_TRACE";
+} // anon namespace
+
+Tracer::Tracer(std::ostream& stream)
+  : mStream(stream)
+  , mStartTime(Clock::now())
+{
+  // the JSON array format, which viewers accept without the closing bracket
+  mStream << "[";
+}
+
+Tracer::Tracer(std::unique_ptr<std::ofstream> pFile)
+  : Tracer(*pFile)
+{
+  mpFile = std::move(pFile);
+}
+
+Tracer::~Tracer()
+{
+  mStream << "\n]\n";
+  mStream.flush();
+}
+
+Tracer* Tracer::instance()
+{
+  static const auto spTracer = []() -> std::unique_ptr<Tracer> {
+    const auto* pPath = std::getenv(kTraceFileVariable);
+    if (!pPath || !*pPath) {
+      return nullptr;
+    }
+
+    auto pFile = estd::make_unique<std::ofstream>(pPath);
+    if (!*pFile) {
+      styleSheetsLogWarning() << "Could not open trace file " << std::string(pPath);
+      return nullptr;
+    }
+
+    styleSheetsLogInfo() << "Tracing to " << std::string(pPath);
+    return std::unique_ptr<Tracer>(new Tracer(std::move(pFile)));
+  }();
+
+  return spTracer.get();
+}
+
+void Tracer::addEvent(const char* pName, Clock::time_point start, Clock::time_point end)
+{
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+
+  const auto threadId = std::hash<std::thread::id>()(std::this_thread::get_id());
+
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  mStream << (mHasEvents ? ",\n" : "\n") << "{\"name\": \"" << pName
+          << "\", \"cat\": \"stylesheets\", \"ph\": \"X\", \"ts\": "
+          << duration_cast<microseconds>(start - mStartTime).count()
+          << ", \"dur\": " << duration_cast<microseconds>(end - start).count()
+          << ", \"pid\": 1, \"tid\": " << (threadId & 0xffffffff) << "}";
+  mHasEvents = true;
+}
+
+} // namespace stylesheets
+} // namespace aqt
@@ -0,0 +1,124 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+
+/*! @cond DOXYGEN_IGNORE */
+
+namespace aqt
+{
+namespace stylesheets
+{
+
+/*! Writes trace events in the Chrome Trace Event format
+ *
+ * The resulting file can be loaded into chrome://tracing or Perfetto.
+ * Tracing is enabled by setting the environment variable
+ * AQT_STYLESHEETS_TRACE to the path of the trace file.  The file is written
+ * while events come in, so it is usable even if the application does not
+ * shut down orderly.
+ *
+ * Events can be added from any thread.
+ */
+class Tracer
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  //! Writes the events to @p stream, which must outlive the tracer
+  explicit Tracer(std::ostream& stream);
+  Tracer(const Tracer&) = delete;
+  Tracer& operator=(const Tracer&) = delete;
+  ~Tracer();
+
+  /*! Returns the tracer selected by the environment; nullptr if tracing is off
+   *
+   * The environment is only looked at on the first call.
+   */
+  static Tracer* instance();
+
+  /*! Adds an event @p pName which started at @p start and ended at @p end
+   *
+   * @p pName must be a string literal or live as long as the tracer.
+   */
+  void addEvent(const char* pName, Clock::time_point start, Clock::time_point end);
+
+private:
+  explicit Tracer(std::unique_ptr<std::ofstream> pFile);
+
+  std::unique_ptr<std::ofstream> mpFile;
+  std::ostream& mStream;
+  std::mutex mMutex;
+  Clock::time_point mStartTime;
+  bool mHasEvents = false;
+};
+
+/*! Adds an event for the lifetime of the scope to the tracer, if any */
+class TraceScope
+{
+public:
+  explicit TraceScope(const char* pName, Tracer* pTracer = Tracer::instance())
+    : mpTracer(pTracer)
+    , mpName(pName)
+  {
+    if (mpTracer) {
+      mStartTime = Tracer::Clock::now();
+    }
+  }
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+  ~TraceScope()
+  {
+    if (mpTracer) {
+      mpTracer->addEvent(mpName, mStartTime, Tracer::Clock::now());
+    }
+  }
+
+private:
+  Tracer* mpTracer;
+  const char* mpName;
+  Tracer::Clock::time_point mStartTime;
+};
+
+} // namespace stylesheets
+} // namespace aqt
+
+#define AQT_STYLESHEETS_TRACE_CONCAT_IMPL(a, b) a##b
+#define AQT_STYLESHEETS_TRACE_CONCAT(a, b) AQT_STYLESHEETS_TRACE_CONCAT_IMPL(a, b)
+
+/*! Traces the rest of the enclosing scope as event @p name
+ *
+ * Costs little more than checking a pointer if tracing is off.
+ */
+#define AQT_STYLESHEETS_TRACE_SCOPE(name)                                              \
+  ::aqt::stylesheets::TraceScope AQT_STYLESHEETS_TRACE_CONCAT(aqtTraceScope_, __LINE__)( \
+    name)
+
+/*! @endcond */
@@ -0,0 +1,82 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "StylePlugin.hpp"
+#include "StyleSet.hpp"
+#include "Warnings.hpp"
+
+SUPPRESS_WARNINGS
+#include <catch/catch.hpp>
+#include <QtCore/QByteArray>
+#include <QtCore/QDir>
+#include <QtCore/QObject>
+#include <QtCore/QUrl>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlEngine>
+#include <QtQml/qqml.h>
+RESTORE_WARNINGS
+
+#include <memory>
+
+namespace aqt
+{
+namespace stylesheets
+{
+namespace tests
+{
+
+/*! Creates the object described by @p qml in @p engine
+ *
+ * Registers the types of the style plugin on first use, like importing the
+ * plugin from QML would.  Relative urls in @p qml are resolved against the
+ * current directory.
+ */
+inline std::unique_ptr<QObject> createQmlObject(QQmlEngine& engine, const char* qml)
+{
+  static const auto isRegistered = [] {
+    StylePlugin().registerTypes("Aqt.StyleSheets");
+    return true;
+  }();
+  (void)isRegistered;
+
+  QQmlComponent component(&engine);
+  component.setData(QByteArray(qml), QUrl::fromLocalFile(QDir::current().filePath(
+                                       QLatin1String("scene.qml"))));
+
+  auto pObject = std::unique_ptr<QObject>(component.create());
+  INFO(component.errorString().toStdString());
+  REQUIRE(pObject);
+
+  return pObject;
+}
+
+/*! Returns the StyleSet attached to @p pObject or nullptr if there is none */
+inline StyleSet* styleSetOf(QObject* pObject)
+{
+  return qobject_cast<StyleSet*>(qmlAttachedPropertiesObject<StyleSet>(pObject, false));
+}
+
+} // namespace tests
+} // namespace stylesheets
+} // namespace aqt
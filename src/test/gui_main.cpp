@@ -0,0 +1,16 @@
+#include "Warnings.hpp"
+
+#define CATCH_CONFIG_RUNNER
+
+SUPPRESS_WARNINGS
+#include <catch/catch.hpp>
+#include <QtGui/QGuiApplication>
+RESTORE_WARNINGS
+
+int main(int argc, char* argv[])
+{
+  // QML items and font lookups need a running gui application
+  QGuiApplication app(argc, argv);
+
+  return Catch::Session().run(argc, argv);
+}
@@ -383,3 +383,20 @@ TEST_CASE("Converting bad url expressions fails", "[convert][expressions]")
     convertProperty<QUrl>(Expression{"rgb", std::vector<std::string>{"1", "2", "3"}}),
     ConvertException);
 }
+
+TEST_CASE("Conversions are counted", "[convert]")
+{
+  const auto count = conversionCount();
+
+  convertProperty<QString>(PropertyValue(std::string("hello")));
+  REQUIRE(conversionCount() == count + 1);
+
+  REQUIRE_THROWS_AS(
+    convertProperty<QUrl>(Expression{"rgb", std::vector<std::string>{"1", "2", "3"}}),
+    ConvertException);
+  REQUIRE(conversionCount() == count + 2);
+
+  convertValueToVariantList({PropertyValue(std::string("a")),
+                             PropertyValue(std::string("b"))});
+  REQUIRE(conversionCount() == count + 4);
+}
@@ -0,0 +1,137 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "PathTrie.hpp"
+
+#include "Warnings.hpp"
+
+SUPPRESS_WARNINGS
+#include <catch/catch.hpp>
+RESTORE_WARNINGS
+
+//========================================================================================
+
+using namespace aqt::stylesheets;
+
+TEST_CASE("Root node represents the empty path", "[pathtrie]")
+{
+  PathTrie trie;
+
+  REQUIRE(trie.root() != nullptr);
+  REQUIRE(trie.root()->parent() == nullptr);
+  REQUIRE(0 == trie.root()->depth());
+  REQUIRE(trie.root()->path().empty());
+  REQUIRE(1 == trie.size());
+
+  REQUIRE(trie.root() == trie.intern(UiItemPath{}));
+}
+
+TEST_CASE("Identical paths are interned to the same node", "[pathtrie]")
+{
+  PathTrie trie;
+
+  UiItemPath p = {PathElement("A"), PathElement("B", {"foo"}), PathElement("C")};
+
+  auto* pNode = trie.intern(p);
+  REQUIRE(pNode == trie.intern(p));
+  REQUIRE(4 == trie.size());
+
+  REQUIRE(3 == pNode->depth());
+  REQUIRE(p == pNode->path());
+  REQUIRE(PathElement("C") == pNode->element());
+}
+
+TEST_CASE("Different paths are interned to different nodes", "[pathtrie]")
+{
+  PathTrie trie;
+
+  auto* pA = trie.intern(UiItemPath{PathElement("A")});
+  auto* pAB = trie.intern(UiItemPath{PathElement("A"), PathElement("B")});
+  auto* pABfoo = trie.intern(UiItemPath{PathElement("A"), PathElement("B", {"foo"})});
+  auto* pB = trie.intern(UiItemPath{PathElement("B")});
+
+  REQUIRE(pA != pAB);
+  REQUIRE(pAB != pABfoo);
+  REQUIRE(pAB != pB);
+  REQUIRE(5 == trie.size());
+}
+
+TEST_CASE("Parent nodes are path prefixes", "[pathtrie]")
+{
+  PathTrie trie;
+
+  auto* pABC =
+    trie.intern(UiItemPath{PathElement("A"), PathElement("B"), PathElement("C")});
+
+  REQUIRE(pABC->parent() == trie.intern(UiItemPath{PathElement("A"), PathElement("B")}));
+  REQUIRE(pABC->parent()->parent() == trie.intern(UiItemPath{PathElement("A")}));
+  REQUIRE(pABC->parent()->parent()->parent() == trie.root());
+
+  REQUIRE(pABC == trie.intern(pABC->parent(), PathElement("C")));
+}
+
+TEST_CASE("Nodes for identical paths have identical hashes", "[pathtrie]")
+{
+  PathTrie trie1;
+  PathTrie trie2;
+
+  UiItemPath p = {PathElement("A", {"x", "y"}), PathElement("B")};
+
+  REQUIRE(trie1.intern(p)->hash() == trie2.intern(p)->hash());
+}
+
+TEST_CASE("Path nodes print like paths", "[pathtrie]")
+{
+  PathTrie trie;
+
+  UiItemPath p = {PathElement("A", {"x", "y"}), PathElement("B", {"z"})};
+
+  REQUIRE("A.{x,y}/B.z" == pathToString(trie.intern(p)));
+}
+
+TEST_CASE("Interning with a precomputed hash yields the same node", "[pathtrie]")
+{
+  PathTrie trie;
+
+  const auto element = PathElement("A");
+
+  auto* pNode = trie.intern(trie.root(), element, hash_value(element));
+  REQUIRE(pNode == trie.intern(trie.root(), element));
+  REQUIRE(pNode == trie.intern(UiItemPath{element}));
+  REQUIRE(2 == trie.size());
+}
+
+TEST_CASE("Relative paths are concatenated to absolute ones", "[pathtrie]")
+{
+  PathTrie trie;
+
+  auto* pPrefix = trie.intern(UiItemPath{PathElement("A"), PathElement("B", {"foo"})});
+  auto* pSuffix = trie.intern(UiItemPath{PathElement("C"), PathElement("D")});
+
+  auto* pNode = trie.concat(pPrefix, pSuffix);
+  REQUIRE(4 == pNode->depth());
+  REQUIRE(pNode == trie.intern(UiItemPath{PathElement("A"), PathElement("B", {"foo"}),
+                                          PathElement("C"), PathElement("D")}));
+
+  REQUIRE(pPrefix == trie.concat(pPrefix, trie.root()));
+  REQUIRE(pSuffix == trie.concat(trie.root(), pSuffix));
+}
@@ -0,0 +1,186 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "StyleMatchTree.hpp"
+
+#include "Property.hpp"
+#include "Warnings.hpp"
+
+SUPPRESS_WARNINGS
+#include <boost/variant/get.hpp>
+#include <catch/catch.hpp>
+#include <QtCore/QString>
+RESTORE_WARNINGS
+
+#include <map>
+#include <string>
+#include <vector>
+
+//========================================================================================
+
+using namespace aqt::stylesheets;
+
+namespace
+{
+Property makeProperty(const std::string& value)
+{
+  return Property(SourceLocation(), PropertyValues{value});
+}
+
+std::string propertyValue(const PropertyMap& pm, const char* pPropertyName)
+{
+  auto it = pm.find(QString(pPropertyName));
+  if (it != pm.end()) {
+    if (const std::string* str = boost::get<std::string>(&it->second.mValues[0])) {
+      return *str;
+    }
+  }
+  return std::string();
+}
+
+std::vector<QString> propertyNames(std::size_t count)
+{
+  std::vector<QString> names;
+  for (std::size_t i = 0; i < count; ++i) {
+    names.emplace_back(QString::fromStdString("property-" + std::to_string(i)));
+  }
+  return names;
+}
+} // anon namespace
+
+TEST_CASE("Empty property map", "[propertymap]")
+{
+  PropertyMap pm;
+
+  REQUIRE(pm.empty());
+  REQUIRE(0 == pm.size());
+  REQUIRE(pm.end() == pm.find(QString("color")));
+}
+
+TEST_CASE("Find properties in property map", "[propertymap]")
+{
+  PropertyMap pm({{QString("color"), makeProperty("red")},
+                  {QString("background"), makeProperty("blue")},
+                  {QString("font"), makeProperty("12px Arial")}});
+
+  REQUIRE(3 == pm.size());
+  REQUIRE("red" == propertyValue(pm, "color"));
+  REQUIRE("blue" == propertyValue(pm, "background"));
+  REQUIRE("12px Arial" == propertyValue(pm, "font"));
+  REQUIRE(pm.end() == pm.find(QString("width")));
+}
+
+TEST_CASE("First entry wins for duplicate property names", "[propertymap]")
+{
+  PropertyMap pm({{QString("color"), makeProperty("red")},
+                  {QString("width"), makeProperty("10")},
+                  {QString("color"), makeProperty("green")}});
+
+  REQUIRE(2 == pm.size());
+  REQUIRE("red" == propertyValue(pm, "color"));
+}
+
+TEST_CASE("Merge inherited properties", "[propertymap]")
+{
+  PropertyMap props({{QString("color"), makeProperty("red")}});
+  PropertyMap inheritedProps({{QString("color"), makeProperty("green")},
+                              {QString("width"), makeProperty("10")}});
+
+  auto pm = mergeInheritedProperties(props, inheritedProps);
+
+  REQUIRE(2 == pm.size());
+  REQUIRE("red" == propertyValue(pm, "color"));
+  REQUIRE("10" == propertyValue(pm, "width"));
+}
+
+TEST_CASE("Compare property values", "[propertymap]")
+{
+  PropertyMap props({{QString("color"), makeProperty("red")},
+                     {QString("width"), makeProperty("10")}});
+  PropertyMap sameProps({{QString("width"), makeProperty("10")},
+                         {QString("color"), makeProperty("red")}});
+  PropertyMap otherProps({{QString("color"), makeProperty("green")},
+                          {QString("width"), makeProperty("10")}});
+  PropertyMap fewerProps({{QString("color"), makeProperty("red")}});
+
+  REQUIRE(haveSameValues(props, props));
+  REQUIRE(haveSameValues(props, sameProps));
+  REQUIRE(!haveSameValues(props, otherProps));
+  REQUIRE(!haveSameValues(props, fewerProps));
+  REQUIRE(!haveSameValues(fewerProps, props));
+
+  PropertyMap movedProps(
+    {{QString("color"), Property(SourceLocation(1, 42, 3, 4), PropertyValues{"red"})},
+     {QString("width"), makeProperty("10")}});
+  REQUIRE(haveSameValues(props, movedProps));
+}
+
+TEST_CASE("Iterate over all properties", "[propertymap]")
+{
+  const auto names = propertyNames(50);
+
+  PropertyMap::Entries entries;
+  for (const auto& name : names) {
+    entries.emplace_back(name, makeProperty(name.toStdString()));
+  }
+  PropertyMap pm(entries);
+
+  REQUIRE(names.size() == pm.size());
+
+  std::size_t count = 0;
+  for (const auto& entry : pm) {
+    REQUIRE(pm.find(entry.first) != pm.end());
+    ++count;
+  }
+  REQUIRE(names.size() == count);
+}
+
+TEST_CASE("Property map lookup performance", "[.][benchmark]")
+{
+  const auto names = propertyNames(40);
+
+  std::map<QString, Property> treeMap;
+  PropertyMap::Entries entries;
+  for (const auto& name : names) {
+    treeMap[name] = makeProperty(name.toStdString());
+    entries.emplace_back(name, makeProperty(name.toStdString()));
+  }
+  PropertyMap flatMap(entries);
+
+  BENCHMARK("std::map lookup")
+  {
+    std::size_t found = 0;
+    for (const auto& name : names) {
+      found += treeMap.find(name) != treeMap.end() ? 1 : 0;
+    }
+    return found;
+  };
+
+  BENCHMARK("PropertyMap lookup")
+  {
+    std::size_t found = 0;
+    for (const auto& name : names) {
+      found += flatMap.find(name) != flatMap.end() ? 1 : 0;
+    }
+    return found;
+  };
+}
@@ -0,0 +1,134 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "StyleCache.hpp"
+
+#include "CssParser.hpp"
+#include "Warnings.hpp"
+
+SUPPRESS_WARNINGS
+#include <boost/variant/get.hpp>
+#include <catch/catch.hpp>
+#include <QtCore/QString>
+RESTORE_WARNINGS
+
+#include <memory>
+#include <string>
+
+//========================================================================================
+
+using namespace aqt::stylesheets;
+
+namespace
+{
+const std::string kKey = "default.css:1234";
+
+const std::string kStyleSheet =
+  "A { color: red; }\n"
+  "A B { background: blue; font: \"Arial\"; }\n"
+  "A .foo { background: rgba(255, 0, 0, 0.5); }\n";
+
+StyleCache::PropertyMaps resolvePaths(PathTrie& trie,
+                                      const std::vector<UiItemPath>& paths)
+{
+  auto pTree = createMatchTree(parseStdString(kStyleSheet));
+
+  StyleCache::PropertyMaps result;
+  for (const auto& path : paths) {
+    result.emplace(trie.intern(path),
+                   std::make_shared<PropertyMap>(matchPath(pTree.get(), path)));
+  }
+
+  return result;
+}
+
+} // anon namespace
+
+TEST_CASE("Style cache restores cached property maps", "[cache]")
+{
+  const auto pathB = UiItemPath{PathElement("A"), PathElement("B")};
+  const auto pathFoo = UiItemPath{PathElement("A"), PathElement("C", {"foo", "x"})};
+
+  PathTrie writingTrie;
+  const auto propertyMaps = resolvePaths(writingTrie, {pathB, pathFoo});
+  const auto data = serializeStyleCache(kKey, propertyMaps);
+
+  PathTrie trie;
+  auto pCache = StyleCache::fromData(data.data(), data.size(), kKey, trie);
+  REQUIRE(pCache);
+  REQUIRE(2 == pCache->size());
+
+  auto pProps = pCache->properties(trie.intern(pathB));
+  REQUIRE(pProps);
+  REQUIRE(2 == pProps->size());
+
+  const auto& original = *propertyMaps.at(writingTrie.intern(pathB));
+  REQUIRE(haveSameValues(original, *pProps));
+  REQUIRE(original.find("font")->second.mSourceLoc.mLine
+          == pProps->find("font")->second.mSourceLoc.mLine);
+
+  pProps = pCache->properties(trie.intern(pathFoo));
+  REQUIRE(pProps);
+  REQUIRE(haveSameValues(*propertyMaps.at(writingTrie.intern(pathFoo)), *pProps));
+  const auto& background = pProps->find("background")->second.mValues;
+  REQUIRE("rgba" == boost::get<Expression>(background[0]).name);
+
+  // the ancestors are interned, but not cached
+  REQUIRE(!pCache->properties(trie.intern(UiItemPath{PathElement("A")})));
+  REQUIRE(!pCache->properties(trie.intern(UiItemPath{PathElement("X")})));
+}
+
+TEST_CASE("Style cache decodes shared property maps once", "[cache]")
+{
+  PathTrie writingTrie;
+  auto propertyMaps = resolvePaths(writingTrie, {{PathElement("A")}});
+  const auto* pPathD = writingTrie.intern(UiItemPath{PathElement("A"), PathElement("D")});
+  propertyMaps.emplace(pPathD, propertyMaps.begin()->second);
+
+  const auto data = serializeStyleCache(kKey, propertyMaps);
+
+  PathTrie trie;
+  auto pCache = StyleCache::fromData(data.data(), data.size(), kKey, trie);
+  REQUIRE(pCache);
+
+  auto pProps = pCache->properties(trie.intern(UiItemPath{PathElement("A")}));
+  REQUIRE(pProps);
+  REQUIRE(pProps
+          == pCache->properties(
+               trie.intern(UiItemPath{PathElement("A"), PathElement("D")})));
+}
+
+TEST_CASE("Style cache rejects stale or damaged data", "[cache]")
+{
+  PathTrie writingTrie;
+  const auto data = serializeStyleCache(
+    kKey, resolvePaths(writingTrie, {{PathElement("A"), PathElement("B")}}));
+
+  PathTrie trie;
+  REQUIRE(!StyleCache::fromData(data.data(), data.size(), "other.css:5678", trie));
+  REQUIRE(!StyleCache::fromData(data.data(), data.size() / 2, kKey, trie));
+  REQUIRE(!StyleCache::fromData(data.data(), 0, kKey, trie));
+
+  auto damaged = data;
+  damaged[0] = 'x';
+  REQUIRE(!StyleCache::fromData(damaged.data(), damaged.size(), kKey, trie));
+}
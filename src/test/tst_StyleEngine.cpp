@@ -0,0 +1,263 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "StyleEngine.hpp"
+
+#include "QmlTestUtils.hpp"
+#include "StyleView.hpp"
+#include "Warnings.hpp"
+
+SUPPRESS_WARNINGS
+#include <catch/catch.hpp>
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QUrl>
+#include <QtQml/QQmlEngine>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+RESTORE_WARNINGS
+
+#include <string>
+#include <vector>
+
+//========================================================================================
+
+using namespace aqt::stylesheets;
+using namespace aqt::stylesheets::tests;
+
+namespace
+{
+const char* const kScene =
+  "import QtQuick 2.3\n"
+  "import Aqt.StyleSheets 1.4\n"
+  "Item {\n"
+  "  StyleEngine { styleSheetSource: \"styleview.css\" }\n"
+  "  Rectangle { objectName: \"panel\"; StyleSet.name: \"panel\" }\n"
+  "}\n";
+
+void writeFile(const QString& path, const char* content)
+{
+  QFile file(path);
+  REQUIRE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+  file.write(content);
+}
+
+QByteArray sceneWithStyleSheet(const QString& path)
+{
+  return QByteArray("import QtQuick 2.3\n"
+                    "import Aqt.StyleSheets 1.4\n"
+                    "Item {\n"
+                    "  StyleEngine { reloadDelay: 50; styleSheetSource: \"")
+         + QUrl::fromLocalFile(path).toEncoded()
+         + QByteArray("\" }\n"
+                      "  Rectangle { objectName: \"panel\"; StyleSet.name: \"panel\" }\n"
+                      "}\n");
+}
+} // anon namespace
+
+TEST_CASE("Counting diagnostics count missing properties", "[diagnostics]")
+{
+  QQmlEngine engine;
+  auto pScene = createQmlObject(engine, kScene);
+  auto* pPanel = pScene->findChild<QObject*>(QLatin1String("panel"));
+  REQUIRE(pPanel);
+
+  auto& styleEngine = StyleEngine::instance();
+  QSignalSpy missingSpy(&styleEngine, SIGNAL(propertiesPotentiallyMissing()));
+  QSignalSpy exceptionSpy(&styleEngine, SIGNAL(exception(QString, QString)));
+
+  StyleView style(pPanel);
+
+  SECTION("nothing is reported in counting mode")
+  {
+    styleEngine.setDiagnostics(StyleEngine::Diagnostics::Counting);
+
+    style.string(QLatin1String("border"));
+    style.color(QLatin1String("border"));
+    style.number(QLatin1String("margin"));
+    styleEngine.checkProperties();
+
+    REQUIRE(styleEngine.missingPropertyCount(QLatin1String("border")) == 2);
+    REQUIRE(styleEngine.missingPropertyCount(QLatin1String("margin")) == 1);
+    REQUIRE(styleEngine.missingPropertyCount(QLatin1String("background")) == 0);
+    REQUIRE(missingSpy.count() == 0);
+    REQUIRE(exceptionSpy.count() == 0);
+  }
+
+  SECTION("missing properties are reported in full mode")
+  {
+    styleEngine.setDiagnostics(StyleEngine::Diagnostics::Full);
+
+    style.string(QLatin1String("border"));
+
+    REQUIRE(styleEngine.missingPropertyCount(QLatin1String("border")) == 0);
+    REQUIRE(missingSpy.count() == 1);
+  }
+}
+
+TEST_CASE("Counting diagnostics back off on conversion failures", "[diagnostics]")
+{
+  QQmlEngine engine;
+  auto pScene = createQmlObject(engine, kScene);
+
+  auto& styleEngine = StyleEngine::instance();
+  REQUIRE(styleEngine.conversionFailureCount() == 0);
+
+  SECTION("only powers of two are reported in counting mode")
+  {
+    styleEngine.setDiagnostics(StyleEngine::Diagnostics::Counting);
+
+    const auto expected = std::vector<bool>{true, true, false, true, false, false,
+                                            false, true};
+    auto reported = std::vector<bool>{};
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      reported.push_back(styleEngine.countConversionFailure());
+    }
+
+    REQUIRE(reported == expected);
+    REQUIRE(styleEngine.conversionFailureCount() == 8);
+  }
+
+  SECTION("all failures are reported in full mode")
+  {
+    styleEngine.setDiagnostics(StyleEngine::Diagnostics::Full);
+
+    for (auto i = 0; i < 8; ++i) {
+      REQUIRE(styleEngine.countConversionFailure());
+    }
+    REQUIRE(styleEngine.conversionFailureCount() == 8);
+  }
+}
+
+TEST_CASE("Style sheets are only reloaded when their content changed", "[reload]")
+{
+  QTemporaryDir dir;
+  REQUIRE(dir.isValid());
+  const auto path = dir.path() + QLatin1String("/reload.css");
+  writeFile(path, ".panel { background: \"black\"; }\n");
+
+  QQmlEngine engine;
+  auto pScene = createQmlObject(engine, sceneWithStyleSheet(path).constData());
+
+  auto& styleEngine = StyleEngine::instance();
+  QSignalSpy changedSpy(&styleEngine, SIGNAL(styleChanged()));
+  const auto reloadCount = styleEngine.stats().reloadCount;
+
+  SECTION("touching the file without changing it does not reload")
+  {
+    writeFile(path, ".panel { background: \"black\"; }\n");
+    QTest::qWait(500);
+
+    REQUIRE(changedSpy.count() == 0);
+    REQUIRE(styleEngine.stats().reloadCount == reloadCount);
+    REQUIRE(!styleEngine.reloadChangedStyles());
+  }
+
+  SECTION("changes in quick succession are reloaded once")
+  {
+    writeFile(path, ".panel { background: \"white\"; }\n");
+    writeFile(path, ".panel { background: \"gray\"; }\n");
+    QTest::qWait(500);
+
+    REQUIRE(changedSpy.count() == 1);
+    REQUIRE(styleEngine.stats().reloadCount == reloadCount + 1);
+    REQUIRE(!styleEngine.reloadChangedStyles());
+  }
+}
+
+TEST_CASE("Missing style sheets are reported once", "[reload]")
+{
+  QTemporaryDir dir;
+  REQUIRE(dir.isValid());
+  const auto path = dir.path() + QLatin1String("/missing.css");
+
+  QQmlEngine engine;
+  auto pScene = createQmlObject(engine, sceneWithStyleSheet(path).constData());
+
+  auto& styleEngine = StyleEngine::instance();
+  QSignalSpy exceptionSpy(&styleEngine, SIGNAL(exception(QString, QString)));
+  QSignalSpy changedSpy(&styleEngine, SIGNAL(styleChanged()));
+
+  REQUIRE(!styleEngine.reloadChangedStyles());
+  REQUIRE(exceptionSpy.count() == 0);
+  REQUIRE(changedSpy.count() == 0);
+
+  writeFile(path, ".panel { background: \"black\"; }\n");
+
+  REQUIRE(styleEngine.reloadChangedStyles());
+  REQUIRE(changedSpy.count() == 1);
+}
+
+TEST_CASE("Switching to a preloaded style sheet keeps unread styles unresolved",
+          "[reload]")
+{
+  QTemporaryDir dir;
+  REQUIRE(dir.isValid());
+  const auto firstPath = dir.path() + QLatin1String("/first.css");
+  const auto secondPath = dir.path() + QLatin1String("/second.css");
+  writeFile(firstPath, ".panel { background: \"black\"; }\n");
+  writeFile(secondPath, ".panel { background: \"white\"; }\n");
+
+  QQmlEngine engine;
+  auto pScene = createQmlObject(engine, sceneWithStyleSheet(firstPath).constData());
+  auto pStyleSet = styleSetOf(pScene->findChild<QObject*>(QLatin1String("panel")));
+  REQUIRE(pStyleSet);
+
+  auto& styleEngine = StyleEngine::instance();
+  styleEngine.preloadStyleSheet(QUrl::fromLocalFile(secondPath), false);
+
+  const auto* pProps = pStyleSet->props();
+  REQUIRE(!pProps->hasBeenRead());
+
+  const auto stats = styleEngine.stats();
+  styleEngine.setStyleSheetSource(QUrl::fromLocalFile(secondPath));
+  styleEngine.loadStyles();
+
+  REQUIRE(styleEngine.stats().preloadedSwitchCount == stats.preloadedSwitchCount + 1);
+  REQUIRE(styleEngine.stats().propertyMapHits == stats.propertyMapHits);
+  REQUIRE(styleEngine.stats().propertyMapMisses == stats.propertyMapMisses);
+  REQUIRE(!pProps->hasBeenRead());
+
+  REQUIRE(pProps->string(QLatin1String("background")) == QLatin1String("white"));
+}
+
+TEST_CASE("Snapshots are only replaced when the styles change", "[snapshot]")
+{
+  QQmlEngine engine;
+  auto pScene = createQmlObject(engine, kScene);
+
+  auto& styleEngine = StyleEngine::instance();
+  auto& pathTrie = styleEngine.pathTrie();
+  const auto pSnapshot = styleEngine.snapshot();
+
+  // resolving new paths does not replace it
+  for (auto i = 0; i < 10; ++i) {
+    const auto typeName = "Item" + std::to_string(i);
+    styleEngine.properties(pathTrie.intern(UiItemPath{PathElement(typeName)}));
+  }
+  REQUIRE(styleEngine.snapshot() == pSnapshot);
+
+  REQUIRE(styleEngine.setOverride(
+    QLatin1String(".panel"), QLatin1String("background"), QLatin1String("\"red\"")));
+  REQUIRE(styleEngine.snapshot() != pSnapshot);
+}
@@ -43,7 +43,7 @@ namespace
 std::string propertyAsString(PropertyMap pm, const char* pPropertyName)
 {
   if (const std::string* str =
-        boost::get<std::string>(&pm[QString(pPropertyName)].mValues[0])) {
+        boost::get<std::string>(&pm.find(QString(pPropertyName))->second.mValues[0])) {
     return *str;
   }
   return std::string();
@@ -51,7 +51,8 @@ std::string propertyAsString(PropertyMap pm, const char* pPropertyName)
 
 QColor propertyAsColor(PropertyMap pm, const char* pPropertyName)
 {
-  auto result = convertProperty<QColor>(pm[QString(pPropertyName)].mValues[0]);
+  auto result =
+    convertProperty<QColor>(pm.find(QString(pPropertyName))->second.mValues[0]);
   if (result) {
     return *result;
   }
@@ -445,6 +446,267 @@ TEST_CASE("Multiple classnames and default stylesheet", "[match]")
   REQUIRE("11" == propertyAsString(pm, "propE"));
 }
 
+TEST_CASE("Style sheet layers", "[match]")
+{
+  const auto base = parseStdString(
+    "Bar     { propA: 1; propB: 1; propC: 1 }\n"
+    "Foo Bar { propD: 1 }\n");
+  const auto theme = parseStdString(
+    "Bar     { propB: 2 }\n"
+    "Foo Bar { propD: 2 }\n");
+  const auto user = parseStdString("Bar { propC: 3 }\n");
+
+  auto mt = createMatchTree({&base, &theme, nullptr, &user});
+  REQUIRE(4 == matchTreeLayerCount(mt.get()));
+
+  UiItemPath p = {PathElement("Foo"), PathElement("Bar")};
+  PropertyMap pm = matchPath(mt.get(), p);
+
+  REQUIRE(4 == pm.size());
+  REQUIRE("1" == propertyAsString(pm, "propA"));
+  REQUIRE("2" == propertyAsString(pm, "propB"));
+  REQUIRE("3" == propertyAsString(pm, "propC"));
+  REQUIRE("2" == propertyAsString(pm, "propD"));
+}
+
+TEST_CASE("More specific rules from lower layers win", "[match]")
+{
+  const auto base = parseStdString("Foo Bar { propA: 1 }\n");
+  const auto user = parseStdString(
+    "Bar     { propA: 2 }\n"
+    "Foo Bar { propB: 2 }\n");
+
+  auto mt = createMatchTree({&base, &user});
+  PropertyMap pm = matchPath(mt.get(), {PathElement("Foo"), PathElement("Bar")});
+
+  REQUIRE(2 == pm.size());
+  REQUIRE("1" == propertyAsString(pm, "propA"));
+  REQUIRE("2" == propertyAsString(pm, "propB"));
+}
+
+TEST_CASE("Replace a style sheet layer", "[match]")
+{
+  const auto base = parseStdString("Bar { propA: 1; propB: 1 }\n");
+  const auto normal = parseStdString("Foo { propA: 2 }\n");
+  const auto highContrast = parseStdString("Bar { propB: 3 }\n");
+
+  auto mt = createMatchTree({&base, &normal, nullptr});
+  auto mt2 = replaceMatchTreeLayer(mt.get(), 1, highContrast);
+
+  REQUIRE(3 == matchTreeLayerCount(mt2.get()));
+
+  const UiItemPath foo = {PathElement("Foo")};
+  const UiItemPath bar = {PathElement("Bar")};
+
+  REQUIRE(isPathMatchedByLayer(mt.get(), 1, foo));
+  REQUIRE(!isPathMatchedByLayer(mt.get(), 1, bar));
+  REQUIRE(!isPathMatchedByLayer(mt2.get(), 1, foo));
+  REQUIRE(isPathMatchedByLayer(mt2.get(), 1, bar));
+  REQUIRE(!isPathMatchedByLayer(mt2.get(), 2, bar));
+
+  PropertyMap pm = matchPath(mt2.get(), bar);
+  REQUIRE(2 == pm.size());
+  REQUIRE("1" == propertyAsString(pm, "propA"));
+  REQUIRE("3" == propertyAsString(pm, "propB"));
+
+  REQUIRE(matchPath(mt2.get(), foo).empty());
+
+  pm = matchPath(mt.get(), bar);
+  REQUIRE("1" == propertyAsString(pm, "propB"));
+}
+
+TEST_CASE("Changed propsets of an edited style sheet", "[match]")
+{
+  const auto before = parseStdString(
+    "Foo { propA: 1 }\n"
+    "Bar { propA: 2 }\n"
+    "Gaz { propA: 3 }\n");
+
+  SECTION("only changes in rules count")
+  {
+    const auto after = parseStdString(
+      "/* a new comment moving all rules */\n"
+      "Foo { propA: 1 }\n"
+      "Bar { propA: 2 }\n"
+      "Gaz { propA: 3 }\n");
+
+    REQUIRE(changedPropsets(before, after).propsets.empty());
+  }
+
+  SECTION("changed rule")
+  {
+    const auto after = parseStdString(
+      "Foo { propA: 1 }\n"
+      "Bar { propA: 4 }\n"
+      "Gaz { propA: 3 }\n");
+
+    const auto changed = changedPropsets(before, after);
+    REQUIRE(2 == changed.propsets.size());
+
+    auto mt = createMatchTree(changed);
+    REQUIRE(!isPathMatchedByLayer(mt.get(), 1, {PathElement("Foo")}));
+    REQUIRE(isPathMatchedByLayer(mt.get(), 1, {PathElement("Bar")}));
+    REQUIRE(!isPathMatchedByLayer(mt.get(), 1, {PathElement("Gaz")}));
+  }
+
+  SECTION("added and removed rules")
+  {
+    const auto after = parseStdString(
+      "Bar { propA: 2 }\n"
+      "Qux { propA: 5 }\n"
+      "Gaz { propA: 3 }\n");
+
+    const auto changed = changedPropsets(before, after);
+    REQUIRE(2 == changed.propsets.size());
+
+    auto mt = createMatchTree(changed);
+    REQUIRE(isPathMatchedByLayer(mt.get(), 1, {PathElement("Foo")}));
+    REQUIRE(isPathMatchedByLayer(mt.get(), 1, {PathElement("Qux")}));
+    REQUIRE(!isPathMatchedByLayer(mt.get(), 1, {PathElement("Gaz")}));
+  }
+
+  SECTION("distant changes")
+  {
+    const auto after = parseStdString(
+      "Foo { propA: 6 }\n"
+      "Bar { propA: 2 }\n"
+      "Gaz { propA: 7 }\n");
+
+    const auto changed = changedPropsets(before, after);
+    REQUIRE(4 == changed.propsets.size());
+
+    auto mt = createMatchTree(changed);
+    REQUIRE(isPathMatchedByLayer(mt.get(), 1, {PathElement("Foo")}));
+    REQUIRE(!isPathMatchedByLayer(mt.get(), 1, {PathElement("Bar")}));
+    REQUIRE(isPathMatchedByLayer(mt.get(), 1, {PathElement("Gaz")}));
+  }
+}
+
+TEST_CASE("Moved propsets of an edited style sheet", "[match]")
+{
+  const auto before = parseStdString(
+    "Foo { propA: 1 }\n"
+    "Bar { propA: 2 }\n"
+    "Gaz { propA: 3 }\n");
+
+  SECTION("unchanged style sheet")
+  {
+    REQUIRE(movedPropsets(before, before).propsets.empty());
+  }
+
+  SECTION("all rules moved")
+  {
+    const auto after = parseStdString(
+      "/* a new comment moving all rules */\n"
+      "Foo { propA: 1 }\n"
+      "Bar { propA: 2 }\n"
+      "Gaz { propA: 3 }\n");
+
+    REQUIRE(3 == movedPropsets(before, after).propsets.size());
+  }
+
+  SECTION("rules following a new line moved")
+  {
+    const auto after = parseStdString(
+      "Foo { propA: 1 }\n"
+      "Bar { propA: 2 }\n"
+      "\n"
+      "Gaz { propA: 3 }\n");
+
+    REQUIRE(changedPropsets(before, after).propsets.empty());
+
+    const auto moved = movedPropsets(before, after);
+    REQUIRE(1 == moved.propsets.size());
+
+    auto mt = createMatchTree(moved);
+    REQUIRE(!isPathMatchedByLayer(mt.get(), 1, {PathElement("Foo")}));
+    REQUIRE(!isPathMatchedByLayer(mt.get(), 1, {PathElement("Bar")}));
+    REQUIRE(isPathMatchedByLayer(mt.get(), 1, {PathElement("Gaz")}));
+  }
+
+  SECTION("a property moved within its rule")
+  {
+    const auto after = parseStdString(
+      "Foo { propA: 1 }\n"
+      "Bar {  propA: 2 }\n"
+      "Gaz { propA: 3 }\n");
+
+    const auto moved = movedPropsets(before, after);
+    REQUIRE(2 == moved.propsets.size());
+
+    auto mt = createMatchTree(moved);
+    REQUIRE(!isPathMatchedByLayer(mt.get(), 1, {PathElement("Foo")}));
+    REQUIRE(isPathMatchedByLayer(mt.get(), 1, {PathElement("Bar")}));
+    REQUIRE(isPathMatchedByLayer(mt.get(), 1, {PathElement("Gaz")}));
+  }
+}
+
+TEST_CASE("Profile rule matching", "[match][profile]")
+{
+  const std::string src =
+    "A { propA: 1 }\n"
+    "X B { propA: 2 }\n"
+    "Dead { propA: 3 }\n"
+    "A { propB: 4 }\n";
+
+  auto mt = createMatchTree(parseStdString(src));
+  auto pProfile = createMatchProfile();
+
+  const UiItemPath a = {PathElement("A")};
+  const UiItemPath ab = {PathElement("A"), PathElement("B")};
+
+  REQUIRE("1" == propertyAsString(matchPath(mt.get(), a, pProfile.get()), "propA"));
+  REQUIRE(matchPath(mt.get(), ab, pProfile.get()).empty());
+  REQUIRE(matchPath(mt.get(), ab, pProfile.get()).empty());
+
+  const auto json = matchProfileToJson(pProfile.get(), mt.get(), {"default", "user"});
+
+  REQUIRE(json.find("\"granularity\": \"selector\"") != std::string::npos);
+
+  // both rules for A are counted together, under the location of the first
+  REQUIRE(json.find("{\"selector\": \"A\", \"source\": \"user\", \"line\": 0")
+          != std::string::npos);
+  REQUIRE(json.find("{\"selector\": \"A\",") == json.rfind("{\"selector\": \"A\","));
+  REQUIRE(json.find("\"tested\": 1, \"steps\": 1, \"matched\": 1, \"won\": 1}")
+          != std::string::npos);
+
+  // the descendant selector is tested on every match of B, but never matches
+  REQUIRE(json.find("{\"selector\": \"X B\", \"source\": \"user\", \"line\": 1")
+          != std::string::npos);
+  REQUIRE(json.find("\"tested\": 2, \"steps\": 8, \"matched\": 0, \"won\": 0}")
+          != std::string::npos);
+
+  REQUIRE(json.find("{\"selector\": \"Dead\", \"source\": \"user\", \"line\": 2")
+          != std::string::npos);
+  REQUIRE(json.find("\"tested\": 0, \"steps\": 0, \"matched\": 0, \"won\": 0}")
+          != std::string::npos);
+
+  REQUIRE(json.find("{\"path\": \"A/B\", \"count\": 2") != std::string::npos);
+  REQUIRE(json.find("{\"path\": \"A\", \"count\": 1") != std::string::npos);
+}
+
+TEST_CASE("Size of match trees", "[match]")
+{
+  REQUIRE(matchTreeSize(nullptr).nodeCount == 0);
+  REQUIRE(matchTreeSize(nullptr).byteCount == 0);
+
+  const auto emptySize = matchTreeSize(createMatchTree(StyleSheet()).get());
+
+  const std::string src =
+    "A { propA: 1 }\n"
+    "X B { propA: 2; propB: \"a rather long value to not fit into a string\" }\n";
+  const auto size = matchTreeSize(createMatchTree(parseStdString(src)).get());
+
+  // A, B, the descendant axis below B and X below that
+  REQUIRE(size.nodeCount == emptySize.nodeCount + 4);
+  REQUIRE(size.byteCount > emptySize.byteCount);
+
+  const auto sizeWithRule =
+    matchTreeSize(createMatchTree(parseStdString(src + "A.foo { propC: 3 }\n")).get());
+  REQUIRE(sizeWithRule.nodeCount > size.nodeCount);
+  REQUIRE(sizeWithRule.byteCount > size.byteCount);
+}
+
 TEST_CASE("Multiple class names undefined class name doesnt matter", "[match]")
 {
   const std::string src =
@@ -0,0 +1,129 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "StyleSetProps.hpp"
+
+#include "QmlTestUtils.hpp"
+#include "StyleSet.hpp"
+#include "Warnings.hpp"
+
+SUPPRESS_WARNINGS
+#include <catch/catch.hpp>
+#include <QtGui/QColor>
+#include <QtQml/QQmlEngine>
+RESTORE_WARNINGS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+//========================================================================================
+
+namespace
+{
+std::atomic<bool> sIsCountingAllocations{false};
+std::atomic<std::size_t> sAllocationCount{0};
+
+//! Counts the allocations done during its lifetime
+class AllocationCounter
+{
+public:
+  AllocationCounter()
+  {
+    sAllocationCount = 0;
+    sIsCountingAllocations = true;
+  }
+
+  ~AllocationCounter()
+  {
+    sIsCountingAllocations = false;
+  }
+
+  std::size_t count() const
+  {
+    return sAllocationCount;
+  }
+};
+} // anon namespace
+
+// Replaced for the whole test executable; allocations are only counted
+// while an AllocationCounter is alive
+void* operator new(std::size_t size)
+{
+  if (sIsCountingAllocations) {
+    ++sAllocationCount;
+  }
+
+  if (auto* p = std::malloc(size > 0 ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+//========================================================================================
+
+using namespace aqt::stylesheets;
+using namespace aqt::stylesheets::tests;
+
+namespace
+{
+const char* const kScene =
+  "import QtQuick 2.3\n"
+  "import Aqt.StyleSheets 1.4\n"
+  "Item {\n"
+  "  StyleEngine { styleSheetSource: \"styleview.css\" }\n"
+  "  Rectangle { objectName: \"panel\"; StyleSet.name: \"panel\" }\n"
+  "}\n";
+} // anon namespace
+
+TEST_CASE("Reading a color does not allocate", "[styleset]")
+{
+  QQmlEngine engine;
+  auto pScene = createQmlObject(engine, kScene);
+  auto* pPanel = pScene->findChild<QObject*>(QLatin1String("panel"));
+  REQUIRE(pPanel);
+
+  auto* pProps = styleSetOf(pPanel)->props();
+  const auto key = QString::fromLatin1("background");
+
+  // the first read resolves the properties and converts the value
+  const auto expected = pProps->color(key);
+  REQUIRE(expected.isValid());
+
+  auto allocationCount = std::size_t(0);
+  auto isSame = true;
+  {
+    AllocationCounter counter;
+    for (auto i = 0; i < 100; ++i) {
+      isSame = isSame && pProps->color(key) == expected;
+    }
+    allocationCount = counter.count();
+  }
+
+  REQUIRE(isSame);
+  REQUIRE(allocationCount == 0);
+}
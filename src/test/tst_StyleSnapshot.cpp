@@ -0,0 +1,118 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "StyleSnapshot.hpp"
+
+#include "CssParser.hpp"
+#include "Warnings.hpp"
+
+SUPPRESS_WARNINGS
+#include <boost/variant/get.hpp>
+#include <catch/catch.hpp>
+#include <QtCore/QString>
+RESTORE_WARNINGS
+
+#include <future>
+#include <memory>
+#include <vector>
+
+//========================================================================================
+
+using namespace aqt::stylesheets;
+
+namespace
+{
+std::string propertyAsString(const PropertyMap& pm, const char* pPropertyName)
+{
+  auto iProp = pm.find(QString(pPropertyName));
+  if (iProp != pm.end()) {
+    if (const std::string* str = boost::get<std::string>(&iProp->second.mValues[0])) {
+      return *str;
+    }
+  }
+  return std::string();
+}
+
+const std::string kStyleSheet =
+  "A { color: red; }\n"
+  "A B { background: blue; }\n"
+  "A .foo { background: green; }\n";
+
+} // anon namespace
+
+TEST_CASE("Snapshot computes inherited properties for uncached paths", "[snapshot]")
+{
+  auto pTrie = std::make_shared<PathTrie>();
+  StyleSnapshot snapshot(createMatchTree(parseStdString(kStyleSheet)), pTrie, {});
+
+  const auto path = UiItemPath{PathElement("A"), PathElement("B")};
+
+  auto pProps = snapshot.properties(pTrie->intern(path));
+  REQUIRE(2 == pProps->size());
+  REQUIRE("red" == propertyAsString(*pProps, "color"));
+  REQUIRE("blue" == propertyAsString(*pProps, "background"));
+
+  auto pPropsByPath = snapshot.properties(path);
+  REQUIRE(2 == pPropsByPath->size());
+  REQUIRE("red" == propertyAsString(*pPropsByPath, "color"));
+  REQUIRE("blue" == propertyAsString(*pPropsByPath, "background"));
+
+  REQUIRE(snapshot.properties(pTrie->root())->empty());
+  REQUIRE(snapshot.properties(UiItemPath{PathElement("X")})->empty());
+}
+
+TEST_CASE("Snapshot returns cached properties as they are", "[snapshot]")
+{
+  auto pTrie = std::make_shared<PathTrie>();
+  auto* pPath = pTrie->intern(UiItemPath{PathElement("A")});
+
+  auto pCached = std::make_shared<const PropertyMap>();
+  StyleSnapshot snapshot(
+    createMatchTree(parseStdString(kStyleSheet)), pTrie, {{pPath, pCached}});
+
+  REQUIRE(pCached == snapshot.properties(pPath));
+
+  // descendants inherit from the cached map
+  auto pProps = snapshot.properties(pTrie->intern(pPath, PathElement("C", {"foo"})));
+  REQUIRE(1 == pProps->size());
+  REQUIRE("green" == propertyAsString(*pProps, "background"));
+}
+
+TEST_CASE("Snapshot can be queried from several threads at once", "[snapshot]")
+{
+  auto pTrie = std::make_shared<PathTrie>();
+  auto pSnapshot = std::make_shared<const StyleSnapshot>(
+    createMatchTree(parseStdString(kStyleSheet)), pTrie, StyleSnapshot::PropertyMaps{});
+
+  const auto path = UiItemPath{PathElement("A"), PathElement("C", {"foo"})};
+
+  std::vector<std::future<std::string>> results;
+  for (int i = 0; i < 4; ++i) {
+    results.emplace_back(std::async(std::launch::async, [pSnapshot, path] {
+      return propertyAsString(*pSnapshot->properties(path), "background");
+    }));
+  }
+
+  for (auto& result : results) {
+    REQUIRE("green" == result.get());
+  }
+}
@@ -0,0 +1,129 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "StyleView.hpp"
+
+#include "QmlTestUtils.hpp"
+#include "StyleSet.hpp"
+#include "Warnings.hpp"
+
+SUPPRESS_WARNINGS
+#include <catch/catch.hpp>
+#include <QtGui/QColor>
+#include <QtQml/QQmlEngine>
+#include <QtQml/qqml.h>
+#include <QtQuick/QQuickItem>
+RESTORE_WARNINGS
+
+#include <memory>
+
+//========================================================================================
+
+using namespace aqt::stylesheets;
+using namespace aqt::stylesheets::tests;
+
+namespace
+{
+const char* const kScene =
+  "import QtQuick 2.3\n"
+  "import Aqt.StyleSheets 1.4\n"
+  "Item {\n"
+  "  StyleEngine { styleSheetSource: \"styleview.css\" }\n"
+  "  Rectangle { objectName: \"panel\"; StyleSet.name: \"panel\" }\n"
+  "}\n";
+} // anon namespace
+
+TEST_CASE("StyleView reads the properties of an item", "[styleview]")
+{
+  QQmlEngine engine;
+  auto pScene = createQmlObject(engine, kScene);
+  auto* pPanel = pScene->findChild<QObject*>(QLatin1String("panel"));
+  REQUIRE(pPanel);
+
+  StyleView style(pPanel);
+
+  REQUIRE(style.isSet(QLatin1String("background")));
+  REQUIRE(!style.isSet(QLatin1String("border")));
+  REQUIRE(style.string(QLatin1String("background")) == QLatin1String("black"));
+  REQUIRE(style.color(QLatin1String("foreground")).isValid());
+  REQUIRE(style.string(QLatin1String("foreground")) == QLatin1String("white"));
+  REQUIRE(style.string(QLatin1String("border")).isEmpty());
+}
+
+TEST_CASE("StyleView attaches a StyleSet if needed", "[styleview]")
+{
+  QQmlEngine engine;
+  auto pScene = createQmlObject(engine, kScene);
+  auto* pPanel = pScene->findChild<QQuickItem*>(QLatin1String("panel"));
+  REQUIRE(pPanel);
+
+  QQuickItem item;
+  item.setParentItem(pPanel);
+  REQUIRE(!styleSetOf(&item));
+
+  StyleView style(&item);
+  REQUIRE(styleSetOf(&item));
+
+  // inherited from the panel
+  REQUIRE(style.string(QLatin1String("background")) == QLatin1String("black"));
+}
+
+TEST_CASE("StyleView reports changes of single properties", "[styleview]")
+{
+  QQmlEngine engine;
+  auto pScene = createQmlObject(engine, kScene);
+  auto* pPanel = pScene->findChild<QObject*>(QLatin1String("panel"));
+  REQUIRE(pPanel);
+
+  StyleView style(pPanel);
+
+  auto anyChanges = 0;
+  auto backgroundChanges = 0;
+  auto foregroundChanges = 0;
+
+  auto pContext = std::unique_ptr<QObject>(new QObject);
+  style.onChanged(pContext.get(), [&] { ++anyChanges; });
+  style.onChanged(
+    QLatin1String("background"), pContext.get(), [&] { ++backgroundChanges; });
+  style.onChanged(
+    QLatin1String("foreground"), pContext.get(), [&] { ++foregroundChanges; });
+
+  // the background stays black, the foreground changes
+  styleSetOf(pPanel)->setName(QLatin1String("frame"));
+  REQUIRE(anyChanges == 1);
+  REQUIRE(backgroundChanges == 0);
+  REQUIRE(foregroundChanges == 1);
+
+  // the background changes, the foreground stays gray
+  styleSetOf(pPanel)->setName(QLatin1String("light"));
+  REQUIRE(anyChanges == 2);
+  REQUIRE(backgroundChanges == 1);
+  REQUIRE(foregroundChanges == 1);
+  REQUIRE(style.string(QLatin1String("background")) == QLatin1String("white"));
+
+  // the callbacks go away with their context
+  pContext.reset();
+  styleSetOf(pPanel)->setName(QLatin1String("panel"));
+  REQUIRE(anyChanges == 2);
+  REQUIRE(backgroundChanges == 1);
+  REQUIRE(foregroundChanges == 1);
+}
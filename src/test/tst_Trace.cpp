@@ -0,0 +1,81 @@
+/*
+Copyright (c) 2016 Ableton AG, Berlin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "Trace.hpp"
+
+#include "Warnings.hpp"
+
+SUPPRESS_WARNINGS
+#include <catch/catch.hpp>
+RESTORE_WARNINGS
+
+#include <sstream>
+#include <string>
+
+//========================================================================================
+
+using namespace aqt::stylesheets;
+
+TEST_CASE("Trace events are written as Chrome trace events", "[trace]")
+{
+  std::ostringstream stream;
+
+  SECTION("no events")
+  {
+    {
+      Tracer tracer(stream);
+    }
+
+    REQUIRE(stream.str() == "[\n]\n");
+  }
+
+  SECTION("scoped events")
+  {
+    {
+      Tracer tracer(stream);
+      {
+        TraceScope outer("outer", &tracer);
+        TraceScope inner("inner", &tracer);
+      }
+    }
+
+    const auto trace = stream.str();
+    REQUIRE(trace.front() == '[');
+    REQUIRE(trace.find("]") == trace.size() - 2);
+
+    // the inner scope ends first
+    const auto innerPos = trace.find("\"name\": \"inner\"");
+    const auto outerPos = trace.find("\"name\": \"outer\"");
+    REQUIRE(innerPos != std::string::npos);
+    REQUIRE(outerPos != std::string::npos);
+    REQUIRE(innerPos < outerPos);
+
+    REQUIRE(trace.find("\"ph\": \"X\"") != std::string::npos);
+    REQUIRE(trace.find("\"cat\": \"stylesheets\"") != std::string::npos);
+    REQUIRE(trace.find("},\n{") != std::string::npos);
+  }
+
+  SECTION("no tracer")
+  {
+    TraceScope scope("unused", nullptr);
+  }
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2016 Ableton AG, Berlin
+
+import QtQuick 2.3
+import QtTest 1.0
+
+import Aqt.StyleSheets 1.4
+import Aqt.Testing 1.0 as AqtTests
+
+Item {
+    id: scene
+
+    /*! ensure minimum width to be larger than the minimum allowed width on
+     * Windows */
+    implicitWidth: 124
+    /*! there are no constraints on the height, but it is convenient to have a
+     *  default size */
+    implicitHeight: 116
+
+    StyleEngine {
+        id: styleEngine
+        defaultStyleSheetSource: "layers/base.css"
+        styleSheetLayers: [ "layers/normal.css" ]
+        styleSheetSource: "layers/user.css"
+    }
+
+    Component {
+        id: layersScene
+
+        Item {
+            property alias button: button
+            property alias label: label
+
+            Rectangle {
+                id: button
+                StyleSet.name: "button"
+
+                property string color: StyleSet.props.string("color")
+                property string background: StyleSet.props.string("background")
+                property string border: StyleSet.props.string("border")
+            }
+
+            Text {
+                id: label
+                StyleSet.name: "label"
+
+                color: StyleSet.props.color("color")
+            }
+        }
+    }
+
+    SignalSpy {
+        id: labelPropsSpy
+        signalName: "propsChanged"
+    }
+
+    TestCase {
+        name: "style sheet layers"
+        when: windowShown
+
+        function test_layersCascade() {
+            AqtTests.Utils.withComponent(layersScene, scene, {}, function(comp) {
+                compare(comp.button.color, "black");
+                compare(comp.button.background, "#eeeeee");
+                compare(comp.button.border, "red");
+            });
+        }
+
+        function test_replaceALayer() {
+            AqtTests.Utils.withComponent(layersScene, scene, {}, function(comp) {
+                labelPropsSpy.target = comp.label.StyleSet.props;
+                labelPropsSpy.clear();
+
+                try {
+                    styleEngine.styleSheetLayers = [ "layers/contrast.css" ];
+
+                    compare(comp.button.color, "white");
+                    compare(comp.button.background, "black");
+                    compare(comp.button.border, "red");
+                    compare(labelPropsSpy.count, 0);
+                } finally {
+                    styleEngine.styleSheetLayers = [ "layers/normal.css" ];
+                    labelPropsSpy.target = null;
+                }
+
+                compare(comp.button.color, "black");
+                compare(comp.button.background, "#eeeeee");
+            });
+        }
+    }
+}
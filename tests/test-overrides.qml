@@ -0,0 +1,101 @@
+// Copyright (c) 2016 Ableton AG, Berlin
+
+import QtQuick 2.3
+import QtTest 1.0
+
+import Aqt.StyleSheets 1.4
+import Aqt.Testing 1.0 as AqtTests
+
+Item {
+    id: scene
+
+    /*! ensure minimum width to be larger than the minimum allowed width on
+     * Windows */
+    implicitWidth: 124
+    /*! there are no constraints on the height, but it is convenient to have a
+     *  default size */
+    implicitHeight: 116
+
+    AqtTests.MsgTracker {
+        id: msgTracker
+    }
+
+    StyleEngine {
+        id: styleEngine
+        styleSheetSource: "props.css"
+    }
+
+    Component {
+        id: overridesScene
+
+        Item {
+            property alias root: root
+            property alias other: other
+
+            Rectangle {
+                id: root
+                StyleSet.name: "root"
+
+                property string bar: StyleSet.props.string("bar")
+            }
+
+            Rectangle {
+                id: other
+                StyleSet.name: "url-test"
+
+                property string icon: StyleSet.props.string("icon2")
+            }
+        }
+    }
+
+    SignalSpy {
+        id: otherPropsSpy
+        signalName: "propsChanged"
+    }
+
+    SignalSpy {
+        id: exceptionSpy
+        target: styleEngine
+        signalName: "exception"
+    }
+
+    TestCase {
+        name: "runtime overrides"
+        when: windowShown
+
+        function test_overrideAProperty() {
+            AqtTests.Utils.withComponent(overridesScene, scene, {}, function(comp) {
+                compare(comp.root.bar, "#123456");
+
+                otherPropsSpy.target = comp.other.StyleSet.props;
+                otherPropsSpy.clear();
+
+                try {
+                    verify(styleEngine.setOverride(".root", "bar", "\"#654321\""));
+                    compare(comp.root.bar, "#654321");
+
+                    verify(styleEngine.setOverride(".root", "bar", "\"#abcdef\""));
+                    compare(comp.root.bar, "#abcdef");
+
+                    styleEngine.clearOverride(".root", "bar");
+                    compare(comp.root.bar, "#123456");
+
+                    compare(otherPropsSpy.count, 0);
+                } finally {
+                    styleEngine.clearOverrides();
+                    otherPropsSpy.target = null;
+                }
+            });
+        }
+
+        function test_rejectInvalidOverrides() {
+            msgTracker.expectMessage(AqtTests.MsgTracker.Warning,
+                                     /^.*Invalid override.*/);
+            exceptionSpy.clear();
+
+            verify(!styleEngine.setOverride(".root", "bar", "\"#654321\"; gaz: 1"));
+            compare(exceptionSpy.count, 1);
+            compare(exceptionSpy.signalArguments[0][0], "invalidOverride");
+        }
+    }
+}
@@ -0,0 +1,83 @@
+// Copyright (c) 2016 Ableton AG, Berlin
+
+import QtQuick 2.3
+import QtTest 1.0
+
+import Aqt.StyleSheets 1.4
+import Aqt.Testing 1.0 as AqtTests
+
+Item {
+    id: scene
+
+    /*! ensure minimum width to be larger than the minimum allowed width on
+     * Windows */
+    implicitWidth: 124
+    /*! there are no constraints on the height, but it is convenient to have a
+     *  default size */
+    implicitHeight: 116
+
+    StyleEngine {
+        id: styleEngine
+        styleSheetSource: "propagation.css"
+    }
+
+    Component {
+        id: nestedScene
+
+        Item {
+            property alias outer: outer
+            property alias renamed: renamed
+            property alias middle: middle
+            property alias inner: inner
+
+            Item {
+                id: outer
+                StyleSet.name: "outer"
+
+                Item {
+                    id: middle
+                    StyleSet.name: "middle"
+
+                    Item {
+                        id: inner
+                        StyleSet.name: "inner"
+                    }
+                }
+            }
+
+            Item {
+                id: renamed
+                StyleSet.name: "renamed"
+            }
+        }
+    }
+
+    TestCase {
+        name: "path propagation"
+        when: windowShown
+
+        function test_renamedAncestorIsSeenInTheSameTurn() {
+            AqtTests.Utils.withComponent(nestedScene, scene, {}, function(comp) {
+                compare(comp.inner.StyleSet.props.string("color"), "red");
+
+                comp.outer.StyleSet.name = "renamed";
+
+                // no event has been processed yet
+                compare(comp.inner.StyleSet.path.indexOf("renamed") >= 0, true);
+                compare(comp.inner.StyleSet.props.string("color"), "blue");
+            });
+        }
+
+        function test_reparentedAncestorIsSeenInTheSameTurn() {
+            AqtTests.Utils.withComponent(nestedScene, scene, {}, function(comp) {
+                compare(comp.inner.StyleSet.props.string("color"), "red");
+
+                comp.middle.parent = comp.renamed;
+
+                // no event has been processed yet
+                compare(comp.inner.StyleSet.props.string("color"), "blue");
+                compare(comp.inner.StyleSet.path.indexOf("outer"), -1);
+            });
+        }
+    }
+}
@@ -0,0 +1,75 @@
+// Copyright (c) 2016 Ableton AG, Berlin
+
+import QtQuick 2.3
+import QtTest 1.0
+
+import Aqt.StyleSheets 1.4
+import Aqt.Testing 1.0 as AqtTests
+
+Item {
+    id: scene
+
+    /*! ensure minimum width to be larger than the minimum allowed width on
+     * Windows */
+    implicitWidth: 124
+    /*! there are no constraints on the height, but it is convenient to have a
+     *  default size */
+    implicitHeight: 116
+
+    StyleEngine {
+        id: styleEngine
+        styleSheetSource: "props.css"
+    }
+
+    Component {
+        id: profiledScene
+
+        Rectangle {
+            StyleSet.name: "root"
+
+            property string bar: StyleSet.props.string("bar")
+        }
+    }
+
+    function findRule(profile, selector) {
+        for (var i = 0; i < profile.rules.length; ++i) {
+            if (profile.rules[i].selector === selector) {
+                return profile.rules[i];
+            }
+        }
+        return null;
+    }
+
+    TestCase {
+        name: "profiling rule matching"
+        when: windowShown
+
+        function test_profileMatching() {
+            compare(styleEngine.matchProfile(), "");
+
+            styleEngine.profiling = true;
+            try {
+                AqtTests.Utils.withComponent(profiledScene, scene, {}, function(comp) {
+                    compare(comp.bar, "#123456");
+
+                    var profile = JSON.parse(styleEngine.matchProfile());
+
+                    var rootRule = findRule(profile, ".root");
+                    verify(rootRule !== null);
+                    verify(rootRule.matched > 0);
+                    verify(rootRule.won > 0);
+
+                    var dotRule = findRule(profile, ".dot");
+                    verify(dotRule !== null);
+                    compare(dotRule.matched, 0);
+
+                    verify(profile.paths.length > 0);
+                });
+            } finally {
+                styleEngine.profiling = false;
+            }
+
+            compare(styleEngine.matchProfile(), "");
+        }
+    }
+}
@@ -4,7 +4,7 @@ import QtQuick 2.3
 import QtTest 1.0
 import QtQuick.Layouts 1.1
 
-import Aqt.StyleSheets 1.3
+import Aqt.StyleSheets 1.4
 import Aqt.Testing 1.0 as AqtTests
 
 Item {
@@ -283,4 +283,58 @@ Item {
             });
         }
     }
+
+
+    //--------------------------------------------------------------------------
+
+    Component {
+        id: allPropertiesScene
+
+        Item {
+            property alias all: rect6.all
+            property alias other: rect7.all
+
+            Rectangle {
+                id: rect6
+                StyleSet.name: "root"
+                anchors.fill: parent
+
+                property var all: StyleSet.props.all
+            }
+
+            Rectangle {
+                id: rect7
+                StyleSet.name: "root"
+
+                property var all: StyleSet.props.all
+            }
+        }
+    }
+
+    TestCase {
+        name: "lookup all properties at once"
+        when: windowShown
+
+        function test_lookupAllProperties() {
+            AqtTests.Utils.withComponent(allPropertiesScene, scene, {}, function(comp) {
+                compare(comp.all.gaz, "hello world!");
+                verify(Qt.colorEqual(comp.all.bar, "#123456"));
+                compare(comp.all.foo.length, 3);
+                compare(comp.all.exprs.length, 3);
+                verify(Qt.colorEqual(comp.all.exprs[0], "red"));
+                compare(comp.all.undefinedProperty, undefined);
+            });
+        }
+
+        function test_allPropertiesAreSharedAndReadOnly() {
+            AqtTests.Utils.withComponent(allPropertiesScene, scene, {}, function(comp) {
+                verify(comp.all === comp.other);
+
+                msgTracker.expectMessage(AqtTests.MsgTracker.Warning,
+                                         /^.*Style property gaz can not be changed.*/);
+                comp.all.gaz = "changed";
+                compare(comp.all.gaz, "hello world!");
+            });
+        }
+    }
 }
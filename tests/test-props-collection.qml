@@ -0,0 +1,66 @@
+// Copyright (c) 2016 Ableton AG, Berlin
+
+import QtQuick 2.3
+import QtTest 1.0
+
+import Aqt.StyleSheets 1.4
+import Aqt.Testing 1.0 as AqtTests
+
+Item {
+    id: scene
+
+    /*! ensure minimum width to be larger than the minimum allowed width on
+     * Windows */
+    implicitWidth: 124
+    /*! there are no constraints on the height, but it is convenient to have a
+     *  default size */
+    implicitHeight: 116
+
+    StyleEngine {
+        id: styleEngine
+        styleSheetSource: "themes/dark.css"
+    }
+
+    Component {
+        id: manyPanels
+
+        Item {
+            Repeater {
+                model: 20
+
+                Rectangle {
+                    StyleSet.name: "panel item" + index
+
+                    property string background: StyleSet.props.string("background")
+                }
+            }
+        }
+    }
+
+    TestCase {
+        name: "collecting unused props"
+        when: windowShown
+
+        function test_unusedPropsAreCollected() {
+            var stats = styleEngine.stats;
+            stats.refresh();
+            var initialCount = stats.styleSetProps;
+
+            AqtTests.Utils.withComponent(manyPanels, scene, {}, function(comp) {
+                stats.refresh();
+                verify(stats.styleSetProps >= initialCount + 20);
+            });
+
+            // have the destroyed items actually deleted
+            wait(0);
+
+            try {
+                // reloading the styles collects the props nobody uses anymore
+                styleEngine.styleSheetSource = "themes/light.css";
+                verify(stats.styleSetProps <= initialCount);
+            } finally {
+                styleEngine.styleSheetSource = "themes/dark.css";
+            }
+        }
+    }
+}
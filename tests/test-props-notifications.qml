@@ -0,0 +1,62 @@
+// Copyright (c) 2016 Ableton AG, Berlin
+
+import QtQuick 2.3
+import QtTest 1.0
+
+import Aqt.StyleSheets 1.4
+import Aqt.Testing 1.0 as AqtTests
+
+Item {
+    id: scene
+
+    /*! ensure minimum width to be larger than the minimum allowed width on
+     * Windows */
+    implicitWidth: 124
+    /*! there are no constraints on the height, but it is convenient to have a
+     *  default size */
+    implicitHeight: 116
+
+    StyleEngine {
+        id: styleEngine
+        styleSheetSource: "themes/dark.css"
+    }
+
+    Component {
+        id: panelScene
+
+        Rectangle {
+            StyleSet.name: "panel"
+        }
+    }
+
+    SignalSpy {
+        id: propsSpy
+        signalName: "propsChanged"
+    }
+
+    TestCase {
+        name: "props notifications"
+        when: windowShown
+
+        function test_unreadPropsAreNotNotified() {
+            AqtTests.Utils.withComponent(panelScene, scene, {}, function(comp) {
+                propsSpy.target = comp.StyleSet.props;
+                propsSpy.clear();
+
+                try {
+                    styleEngine.styleSheetSource = "themes/light.css";
+                    compare(propsSpy.count, 0);
+
+                    compare(comp.StyleSet.props.string("background"), "white");
+
+                    styleEngine.styleSheetSource = "themes/dark.css";
+                    compare(propsSpy.count, 1);
+                    compare(comp.StyleSet.props.string("background"), "black");
+                } finally {
+                    styleEngine.styleSheetSource = "themes/dark.css";
+                    propsSpy.target = null;
+                }
+            });
+        }
+    }
+}
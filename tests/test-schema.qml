@@ -0,0 +1,103 @@
+// Copyright (c) 2016 Ableton AG, Berlin
+
+import QtQuick 2.3
+import QtTest 1.0
+
+import Aqt.StyleSheets 1.4
+import Aqt.Testing 1.0 as AqtTests
+
+Item {
+    id: scene
+
+    /*! ensure minimum width to be larger than the minimum allowed width on
+     * Windows */
+    implicitWidth: 124
+    /*! there are no constraints on the height, but it is convenient to have a
+     *  default size */
+    implicitHeight: 116
+
+    AqtTests.MsgTracker {
+        id: msgTracker
+    }
+
+    StyleEngine {
+        id: styleEngine
+        styleSheetSource: "props.css"
+    }
+
+    StyleSchema {
+        id: rootSchema
+        properties: { "bar": "color", "gaz": "string" }
+    }
+
+    StyleSchema {
+        id: badSchema
+        properties: { "gaz": "number", "nothing": "string" }
+    }
+
+    Component {
+        id: schemaScene
+
+        Item {
+            property alias style: rect.style
+
+            Rectangle {
+                id: rect
+                StyleSet.name: "root"
+                anchors.fill: parent
+
+                property var style: rootSchema.resolve(StyleSet.props)
+            }
+        }
+    }
+
+    Component {
+        id: badSchemaScene
+
+        Item {
+            property alias style: rect.style
+
+            Rectangle {
+                id: rect
+                StyleSet.name: "root"
+                anchors.fill: parent
+
+                property var style: badSchema.resolve(StyleSet.props)
+            }
+        }
+    }
+
+    TestCase {
+        name: "resolve a schema"
+        when: windowShown
+
+        function test_keysAndIndices() {
+            compare(rootSchema.keys.length, 2);
+            compare(rootSchema.keys[rootSchema.indexOf("bar")], "bar");
+            compare(rootSchema.keys[rootSchema.indexOf("gaz")], "gaz");
+            compare(rootSchema.indexOf("nothing"), -1);
+        }
+
+        function test_resolveTypedValues() {
+            AqtTests.Utils.withComponent(schemaScene, scene, {}, function(comp) {
+                compare(comp.style.length, 2);
+                verify(Qt.colorEqual(comp.style[rootSchema.indexOf("bar")], "#123456"));
+                compare(comp.style[rootSchema.indexOf("gaz")], "hello world!");
+                compare(rootSchema.errors.length, 0);
+            });
+        }
+
+        function test_reportMissingAndUnconvertibleProperties() {
+            msgTracker.expectMessage(AqtTests.MsgTracker.Warning,
+                                     /^.*Property 'gaz' is not convertible.*/);
+            msgTracker.expectMessage(AqtTests.MsgTracker.Warning,
+                                     /^.*Property 'nothing' not found.*/);
+            AqtTests.Utils.withComponent(badSchemaScene, scene, {}, function(comp) {
+                compare(comp.style.length, 2);
+                compare(comp.style[badSchema.indexOf("gaz")], undefined);
+                compare(comp.style[badSchema.indexOf("nothing")], undefined);
+                compare(badSchema.errors.length, 2);
+            });
+        }
+    }
+}
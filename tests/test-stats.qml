@@ -0,0 +1,63 @@
+// Copyright (c) 2016 Ableton AG, Berlin
+
+import QtQuick 2.3
+import QtTest 1.0
+
+import Aqt.StyleSheets 1.4
+import Aqt.Testing 1.0 as AqtTests
+
+Item {
+    id: scene
+
+    /*! ensure minimum width to be larger than the minimum allowed width on
+     * Windows */
+    implicitWidth: 124
+    /*! there are no constraints on the height, but it is convenient to have a
+     *  default size */
+    implicitHeight: 116
+
+    StyleEngine {
+        id: styleEngine
+        styleSheetSource: "props.css"
+    }
+
+    Component {
+        id: styledScene
+
+        Rectangle {
+            StyleSet.name: "root"
+
+            property string bar: StyleSet.props.string("bar")
+        }
+    }
+
+    TestCase {
+        name: "engine statistics"
+        when: windowShown
+
+        function test_stats() {
+            var stats = styleEngine.stats;
+
+            verify(stats.reloads > 0);
+            verify(stats.lastReloadDuration >= 0);
+            verify(stats.totalReloadDuration >= stats.lastReloadDuration);
+            verify(stats.matchTreeNodes > 0);
+            verify(stats.matchTreeBytes > stats.matchTreeNodes);
+
+            var conversions = stats.conversions;
+
+            AqtTests.Utils.withComponent(styledScene, scene, {}, function(comp) {
+                compare(comp.bar, "#123456");
+
+                stats.refresh();
+                verify(stats.styleSetProps > 0);
+                verify(stats.cachedPaths > 0);
+                verify(stats.uniquePropertyMaps > 0);
+                verify(stats.uniquePropertyMaps <= stats.cachedPaths);
+                verify(stats.propertyMapMisses > 0);
+                verify(stats.conversions > conversions);
+                verify(stats.propertyMapHitRate >= 0 && stats.propertyMapHitRate <= 1);
+            });
+        }
+    }
+}
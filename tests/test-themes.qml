@@ -0,0 +1,123 @@
+// Copyright (c) 2016 Ableton AG, Berlin
+
+import QtQuick 2.3
+import QtTest 1.0
+
+import Aqt.StyleSheets 1.4
+import Aqt.Testing 1.0 as AqtTests
+
+Item {
+    id: scene
+
+    /*! ensure minimum width to be larger than the minimum allowed width on
+     * Windows */
+    implicitWidth: 124
+    /*! there are no constraints on the height, but it is convenient to have a
+     *  default size */
+    implicitHeight: 116
+
+    StyleEngine {
+        id: styleEngine
+        defaultStyleSheetSource: "themes/base.css"
+        themes: { "dark": "themes/dark.css", "light": "themes/light.css" }
+        theme: "dark"
+    }
+
+    Component {
+        id: themedScene
+
+        Item {
+            property alias panel: panel
+            property alias label: label
+
+            Rectangle {
+                id: panel
+                StyleSet.name: "panel"
+
+                property string background: StyleSet.props.string("background")
+                property string foreground: StyleSet.props.string("foreground")
+                property string border: StyleSet.props.string("border")
+            }
+
+            Text {
+                id: label
+                StyleSet.name: "label"
+
+                property string fontSize: StyleSet.props.string("font-size")
+            }
+        }
+    }
+
+    SignalSpy {
+        id: labelPropsSpy
+        signalName: "propsChanged"
+    }
+
+    TestCase {
+        name: "switch themes"
+        when: windowShown
+
+        function test_switchThemes() {
+            AqtTests.Utils.withComponent(themedScene, scene, {}, function(comp) {
+                compare(comp.panel.background, "black");
+                compare(comp.panel.foreground, "white");
+                compare(comp.panel.border, "gray");
+                compare(comp.label.fontSize, "12");
+
+                var preloadedSwitches = styleEngine.stats.preloadedSwitches;
+                labelPropsSpy.target = comp.label.StyleSet.props;
+                labelPropsSpy.clear();
+
+                try {
+                    styleEngine.theme = "light";
+                    compare(styleEngine.styleSheetSource.toString().indexOf("light.css") >= 0,
+                            true);
+                    compare(comp.panel.background, "white");
+                    compare(comp.panel.foreground, "black");
+                    compare(comp.panel.border, "gray");
+                    compare(comp.label.fontSize, "12");
+
+                    styleEngine.theme = "dark";
+                    compare(comp.panel.background, "black");
+                    compare(comp.panel.foreground, "white");
+
+                    // both switches took the match trees compiled ahead
+                    compare(styleEngine.stats.preloadedSwitches, preloadedSwitches + 2);
+
+                    // the label's properties have the same values in both themes
+                    compare(labelPropsSpy.count, 0);
+                } finally {
+                    styleEngine.theme = "dark";
+                    labelPropsSpy.target = null;
+                }
+            });
+        }
+
+        function test_overridesApplyToPreloadedThemes() {
+            AqtTests.Utils.withComponent(themedScene, scene, {}, function(comp) {
+                var preloadedSwitches = styleEngine.stats.preloadedSwitches;
+
+                try {
+                    verify(styleEngine.setOverride(".panel", "background", "\"red\""));
+                    compare(comp.panel.background, "red");
+
+                    styleEngine.theme = "light";
+                    compare(styleEngine.stats.preloadedSwitches, preloadedSwitches + 1);
+                    compare(comp.panel.background, "red");
+                    compare(comp.panel.foreground, "black");
+                    compare(comp.panel.border, "gray");
+
+                    styleEngine.clearOverrides();
+                    compare(comp.panel.background, "white");
+
+                    styleEngine.theme = "dark";
+                    compare(styleEngine.stats.preloadedSwitches, preloadedSwitches + 2);
+                    compare(comp.panel.background, "black");
+                } finally {
+                    styleEngine.clearOverrides();
+                    styleEngine.theme = "dark";
+                }
+            });
+        }
+    }
+}